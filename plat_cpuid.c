@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === Runtime detection of x86-64 instruction set extensions. */
+
+#include "plat_local.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <cpuid.h>
+
+/* XCR0 (extended control register) via XGETBV; the OS enables the */
+/* wide register state there. Encoded as bytes for old assemblers. */
+
+static uint64_t plat_xgetbv0(void)
+{
+  uint32_t lo, hi;
+  __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"
+                       : "=a"(lo), "=d"(hi)
+                       : "c"(0));
+  return (((uint64_t)hi) << 32) | lo;
+}
+
+static uint32_t plat_x64_detect(void)
+{
+  unsigned int a, b, c, d;
+  unsigned int c1, b7;
+  uint64_t xcr0 = 0;
+  uint32_t feat = 0;
+
+  if (!__get_cpuid(1, &a, &b, &c, &d))
+  {
+    return 0;
+  }
+  c1 = c;
+
+  if (__get_cpuid_max(0, NULL) < 7)
+  {
+    return 0;
+  }
+  __cpuid_count(7, 0, a, b, c, d);
+  b7 = b;
+
+  /* OSXSAVE: XGETBV is usable */
+  if ((c1 >> 27) & 1)
+  {
+    xcr0 = plat_xgetbv0();
+  }
+
+  /* SHA (7:EBX.29) + SSSE3 (1:ECX.9) + SSE4.1 (1:ECX.19); XMM only */
+  if (((b7 >> 29) & 1) && ((c1 >> 9) & 1) && ((c1 >> 19) & 1))
+  {
+    feat |= PLAT_X64_SHA;
+  }
+
+  /* AVX2 (7:EBX.5) + AVX (1:ECX.28); XMM and YMM state enabled */
+  if (((b7 >> 5) & 1) && ((c1 >> 28) & 1) && (xcr0 & 0x06) == 0x06)
+  {
+    feat |= PLAT_X64_AVX2;
+
+    /* AVX512F (7:EBX.16) + AVX512VL (7:EBX.31); opmask and ZMM state */
+    if (((b7 >> 16) & 1) && ((b7 >> 31) & 1) && (xcr0 & 0xE0) == 0xE0)
+    {
+      feat |= PLAT_X64_AVX512;
+    }
+  }
+
+  return feat;
+}
+
+/* Detection runs once; concurrent first calls store the same value. */
+
+#define PLAT_X64_DETECTED 0x80000000
+
+#ifdef SLH_EXPERIMENTAL
+/* test hook: features outside the mask are reported as absent */
+uint32_t plat_x64_mask = 0xFFFFFFFF;
+#endif
+
+uint32_t plat_x64_features(void)
+{
+  static volatile uint32_t feat = 0;
+  uint32_t f = feat;
+
+  if (f == 0)
+  {
+    f = plat_x64_detect() | PLAT_X64_DETECTED;
+    feat = f;
+  }
+#ifdef SLH_EXPERIMENTAL
+  f &= plat_x64_mask | PLAT_X64_DETECTED;
+#endif
+  return f;
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(plat_cpuid)
+
+#endif /* PLAT_X64_SIMD */
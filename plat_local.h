@@ -76,6 +76,23 @@ extern "C"
 /* PLAT_XLEN signals that the rest of the macros are defined too */
 #endif
 
+/* === x86-64 SIMD extensions, selected at runtime */
+
+/* Kernels are compiled with function-level target attributes, so no */
+/* special compiler flags are needed. Define PLAT_NO_SIMD to disable. */
+
+#if defined(PLAT_ARCH_X64) && !defined(PLAT_NO_SIMD) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define PLAT_X64_SIMD
+
+#define PLAT_X64_SHA 0x01    /* SHA extensions, SSSE3 and SSE4.1 */
+#define PLAT_X64_AVX2 0x02   /* AVX2 (with OS support for YMM state) */
+#define PLAT_X64_AVX512 0x04 /* AVX-512 F and VL (with OS support) */
+
+  /* Return a bitmask of the PLAT_X64_* features of the running CPU. */
+  uint32_t plat_x64_features(void);
+#endif
+
 /* === Assume-Assert checks */
 
 /* No-op for production */
@@ -158,6 +175,37 @@ static SLH_INLINE uint64_t rev8_be64(uint64_t x)
     return (x >> n) | (x << (64 - n));
   }
 
+  /* bit (un)interleave (RISC-V ZIP / UNZIP): unzip32 moves even bits */
+  /* to the low half and odd bits to the high half; zip32 is the inverse */
+
+  static SLH_INLINE uint32_t unzip32(uint32_t x)
+  {
+    uint32_t t;
+    t = (x ^ (x >> 1)) & 0x22222222;
+    x ^= t ^ (t << 1);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0C;
+    x ^= t ^ (t << 2);
+    t = (x ^ (x >> 4)) & 0x00F000F0;
+    x ^= t ^ (t << 4);
+    t = (x ^ (x >> 8)) & 0x0000FF00;
+    x ^= t ^ (t << 8);
+    return x;
+  }
+
+  static SLH_INLINE uint32_t zip32(uint32_t x)
+  {
+    uint32_t t;
+    t = (x ^ (x >> 8)) & 0x0000FF00;
+    x ^= t ^ (t << 8);
+    t = (x ^ (x >> 4)) & 0x00F000F0;
+    x ^= t ^ (t << 4);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0C;
+    x ^= t ^ (t << 2);
+    t = (x ^ (x >> 1)) & 0x22222222;
+    x ^= t ^ (t << 1);
+    return x;
+  }
+
   /* and with negate (RISC-V ANDN) */
 
   static SLH_INLINE uint32_t andn32(uint32_t x, uint32_t y) { return x & ~y; }
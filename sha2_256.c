@@ -31,69 +31,312 @@ uint64_t sha2_256_compress_count = 0; /* instrumentation */
           (ror32(xe, 17) ^ ror32(xe, 19) ^ (xe >> 10));     \
   }
 
-void sha2_256_compress(void *v)
+/* 4.2.2 SHA-224 and SHA-256 Constants */
+
+const uint32_t sha2_256_k[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1,
+    0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786,
+    0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147,
+    0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+    0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A,
+    0x5B9CCA4F, 0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2};
+
+/* portable compression of "nblk" consecutive 64-byte blocks at "m" */
+
+static void sha2_256_compress_blocks_c(void *s, const uint8_t *m, size_t nblk)
 {
-  /* 4.2.2 SHA-224 and SHA-256 Constants */
-
-  const uint32_t ck[64] = {
-      0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1,
-      0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
-      0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786,
-      0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
-      0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147,
-      0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
-      0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
-      0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
-      0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A,
-      0x5B9CCA4F, 0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
-      0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2};
-
   uint32_t a, b, c, d, e, f, g, h;
   uint32_t m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, ma, mb, mc, md, me, mf;
 
-  uint32_t *sp = (uint32_t *)v;
-  const uint32_t *mp = sp + 8;
-  const uint32_t *kp = ck;
+  uint32_t *sp = (uint32_t *)s;
+  const uint32_t *kp;
+
+  /* get state */
+  sp[0] = rev8_be32(sp[0]);
+  sp[1] = rev8_be32(sp[1]);
+  sp[2] = rev8_be32(sp[2]);
+  sp[3] = rev8_be32(sp[3]);
+  sp[4] = rev8_be32(sp[4]);
+  sp[5] = rev8_be32(sp[5]);
+  sp[6] = rev8_be32(sp[6]);
+  sp[7] = rev8_be32(sp[7]);
+
+  for (; nblk > 0; nblk--)
+  {
+    a = sp[0];
+    b = sp[1];
+    c = sp[2];
+    d = sp[3];
+    e = sp[4];
+    f = sp[5];
+    g = sp[6];
+    h = sp[7];
+
+    /* load big-endian message words */
+
+    m0 = get32u_be(m);
+    m1 = get32u_be(m + 4);
+    m2 = get32u_be(m + 8);
+    m3 = get32u_be(m + 12);
+    m4 = get32u_be(m + 16);
+    m5 = get32u_be(m + 20);
+    m6 = get32u_be(m + 24);
+    m7 = get32u_be(m + 28);
+    m8 = get32u_be(m + 32);
+    m9 = get32u_be(m + 36);
+    ma = get32u_be(m + 40);
+    mb = get32u_be(m + 44);
+    mc = get32u_be(m + 48);
+    md = get32u_be(m + 52);
+    me = get32u_be(m + 56);
+    mf = get32u_be(m + 60);
+    m += 64;
+
+    kp = sha2_256_k;
+    while (1)
+    {
+      STEP_SHA256_R(a, b, c, d, e, f, g, h, m0, kp[0]); /* rounds */
+      STEP_SHA256_R(h, a, b, c, d, e, f, g, m1, kp[1]);
+      STEP_SHA256_R(g, h, a, b, c, d, e, f, m2, kp[2]);
+      STEP_SHA256_R(f, g, h, a, b, c, d, e, m3, kp[3]);
+      STEP_SHA256_R(e, f, g, h, a, b, c, d, m4, kp[4]);
+      STEP_SHA256_R(d, e, f, g, h, a, b, c, m5, kp[5]);
+      STEP_SHA256_R(c, d, e, f, g, h, a, b, m6, kp[6]);
+      STEP_SHA256_R(b, c, d, e, f, g, h, a, m7, kp[7]);
+      STEP_SHA256_R(a, b, c, d, e, f, g, h, m8, kp[8]);
+      STEP_SHA256_R(h, a, b, c, d, e, f, g, m9, kp[9]);
+      STEP_SHA256_R(g, h, a, b, c, d, e, f, ma, kp[10]);
+      STEP_SHA256_R(f, g, h, a, b, c, d, e, mb, kp[11]);
+      STEP_SHA256_R(e, f, g, h, a, b, c, d, mc, kp[12]);
+      STEP_SHA256_R(d, e, f, g, h, a, b, c, md, kp[13]);
+      STEP_SHA256_R(c, d, e, f, g, h, a, b, me, kp[14]);
+      STEP_SHA256_R(b, c, d, e, f, g, h, a, mf, kp[15]);
+
+      if (kp == &sha2_256_k[64 - 16])
+      {
+        break;
+      }
+      kp += 16;
+
+      STEP_SHA256_K(m0, m1, m9, me); /* message schedule */
+      STEP_SHA256_K(m1, m2, ma, mf);
+      STEP_SHA256_K(m2, m3, mb, m0);
+      STEP_SHA256_K(m3, m4, mc, m1);
+      STEP_SHA256_K(m4, m5, md, m2);
+      STEP_SHA256_K(m5, m6, me, m3);
+      STEP_SHA256_K(m6, m7, mf, m4);
+      STEP_SHA256_K(m7, m8, m0, m5);
+      STEP_SHA256_K(m8, m9, m1, m6);
+      STEP_SHA256_K(m9, ma, m2, m7);
+      STEP_SHA256_K(ma, mb, m3, m8);
+      STEP_SHA256_K(mb, mc, m4, m9);
+      STEP_SHA256_K(mc, md, m5, ma);
+      STEP_SHA256_K(md, me, m6, mb);
+      STEP_SHA256_K(me, mf, m7, mc);
+      STEP_SHA256_K(mf, m0, m8, md);
+    }
+
+    sp[0] += a;
+    sp[1] += b;
+    sp[2] += c;
+    sp[3] += d;
+    sp[4] += e;
+    sp[5] += f;
+    sp[6] += g;
+    sp[7] += h;
+  }
+
+  sp[0] = rev8_be32(sp[0]);
+  sp[1] = rev8_be32(sp[1]);
+  sp[2] = rev8_be32(sp[2]);
+  sp[3] = rev8_be32(sp[3]);
+  sp[4] = rev8_be32(sp[4]);
+  sp[5] = rev8_be32(sp[5]);
+  sp[6] = rev8_be32(sp[6]);
+  sp[7] = rev8_be32(sp[7]);
+}
+
+/* compress "nblk" blocks from "m" directly into the state "s"; */
+/* selects a hardware implementation if available */
+
+void sha2_256_compress_blocks(void *s, const uint8_t *m, size_t nblk)
+{
+#ifdef SLH_EXPERIMENTAL
+  sha2_256_compress_count += nblk; /* instrumentation */
+#endif
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_SHA)
+  {
+    sha2_256_compress_blocks_shani(s, m, nblk);
+    return;
+  }
+#endif
+
+  sha2_256_compress_blocks_c(s, m, nblk);
+}
+
+/* compression function; the block follows the state in "v" */
+
+void sha2_256_compress(void *v)
+{
+  sha2_256_compress_blocks(v, (const uint8_t *)v + 32, 1);
+}
+
+/* eight independent compressions, using SIMD lanes if available. */
+/* Without them, only the lanes in "act" are computed */
+
+void sha2_256_compress_x8(void *v[8], uint32_t act)
+{
+  int i;
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_AVX2)
+  {
+#ifdef SLH_EXPERIMENTAL
+    for (i = 0; i < 8; i++)
+    {
+      sha2_256_compress_count += (act >> i) & 1; /* instrumentation */
+    }
+#endif
+    sha2_256_compress_x8_avx2(v);
+    return;
+  }
+#endif
+
+  for (i = 0; i < 8; i++)
+  {
+    if ((act >> i) & 1)
+    {
+      sha2_256_compress(v[i]);
+    }
+  }
+}
+
+/* sixteen independent compressions, using SIMD lanes if available */
+
+void sha2_256_compress_x16(void *v[16], uint32_t act)
+{
+#ifdef PLAT_X64_SIMD
+#ifdef SLH_EXPERIMENTAL
+  int i;
+#endif
 
+  if (plat_x64_features() & PLAT_X64_AVX512)
+  {
 #ifdef SLH_EXPERIMENTAL
-  sha2_256_compress_count++; /* instrumentation */
+    for (i = 0; i < 16; i++)
+    {
+      sha2_256_compress_count += (act >> i) & 1; /* instrumentation */
+    }
+#endif
+    sha2_256_compress_x16_avx512(v);
+    return;
+  }
 #endif
 
-  a = sp[0] = rev8_be32(sp[0]);
-  b = sp[1] = rev8_be32(sp[1]);
-  c = sp[2] = rev8_be32(sp[2]);
-  d = sp[3] = rev8_be32(sp[3]);
-  e = sp[4] = rev8_be32(sp[4]);
-  f = sp[5] = rev8_be32(sp[5]);
-  g = sp[6] = rev8_be32(sp[6]);
-  h = sp[7] = rev8_be32(sp[7]);
-
-  /* load and reverse bytes (if needed) */
-
-  m0 = rev8_be32(mp[0]);
-  m1 = rev8_be32(mp[1]);
-  m2 = rev8_be32(mp[2]);
-  m3 = rev8_be32(mp[3]);
-  m4 = rev8_be32(mp[4]);
-  m5 = rev8_be32(mp[5]);
-  m6 = rev8_be32(mp[6]);
-  m7 = rev8_be32(mp[7]);
-  m8 = rev8_be32(mp[8]);
-  m9 = rev8_be32(mp[9]);
-  ma = rev8_be32(mp[10]);
-  mb = rev8_be32(mp[11]);
-  mc = rev8_be32(mp[12]);
-  md = rev8_be32(mp[13]);
-  me = rev8_be32(mp[14]);
-  mf = rev8_be32(mp[15]);
+  sha2_256_compress_x8(v, act & 0xFF);
+  sha2_256_compress_x8(v + 8, (act >> 8) & 0xFF);
+}
+
+/* number of independent compressions worth batching per call: 16 or 8 */
+/* with the SIMD kernels, or 1 if single compressions are as fast */
+
+size_t sha2_256_lanes(void)
+{
+#ifdef PLAT_X64_SIMD
+  uint32_t f = plat_x64_features();
+
+  if (f & PLAT_X64_AVX512)
+  {
+    return 16;
+  }
+  if ((f & PLAT_X64_AVX2) && !(f & PLAT_X64_SHA))
+  {
+    return 8; /* the SHA extensions beat 8-lane AVX2 */
+  }
+#endif
+  return 1;
+}
+
+/* portable hash chain; the state after the first four rounds, which */
+/* only depend on the fixed words 0..3 of the block, is computed once */
+
+static void sha2_256_chain_blocks_c(uint8_t *y, const void *iv, uint8_t *m,
+                                    size_t off, size_t n, size_t nstep)
+{
+  uint32_t a, b, c, d, e, f, g, h;
+  uint32_t m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, ma, mb, mc, md, me, mf;
+  uint32_t w0, w1, w2, w3, r[8], s[8];
+  const uint32_t *kp;
+  uint8_t buf[32];
+  int i;
+
+  for (i = 0; i < 8; i++)
+  {
+    s[i] = get32u_be((const uint8_t *)iv + 4 * i);
+  }
+  w0 = get32u_be(m);
+  w1 = get32u_be(m + 4);
+  w2 = get32u_be(m + 8);
+  w3 = get32u_be(m + 12);
+
+  a = s[0];
+  b = s[1];
+  c = s[2];
+  d = s[3];
+  e = s[4];
+  f = s[5];
+  g = s[6];
+  h = s[7];
+  STEP_SHA256_R(a, b, c, d, e, f, g, h, w0, sha2_256_k[0]);
+  STEP_SHA256_R(h, a, b, c, d, e, f, g, w1, sha2_256_k[1]);
+  STEP_SHA256_R(g, h, a, b, c, d, e, f, w2, sha2_256_k[2]);
+  STEP_SHA256_R(f, g, h, a, b, c, d, e, w3, sha2_256_k[3]);
+  r[0] = a;
+  r[1] = b;
+  r[2] = c;
+  r[3] = d;
+  r[4] = e;
+  r[5] = f;
+  r[6] = g;
+  r[7] = h;
 
   while (1)
   {
-    STEP_SHA256_R(a, b, c, d, e, f, g, h, m0, kp[0]); /* rounds */
-    STEP_SHA256_R(h, a, b, c, d, e, f, g, m1, kp[1]);
-    STEP_SHA256_R(g, h, a, b, c, d, e, f, m2, kp[2]);
-    STEP_SHA256_R(f, g, h, a, b, c, d, e, m3, kp[3]);
-    STEP_SHA256_R(e, f, g, h, a, b, c, d, m4, kp[4]);
+    a = r[0];
+    b = r[1];
+    c = r[2];
+    d = r[3];
+    e = r[4];
+    f = r[5];
+    g = r[6];
+    h = r[7];
+
+    m0 = w0;
+    m1 = w1;
+    m2 = w2;
+    m3 = w3;
+    m4 = get32u_be(m + 16);
+    m5 = get32u_be(m + 20);
+    m6 = get32u_be(m + 24);
+    m7 = get32u_be(m + 28);
+    m8 = get32u_be(m + 32);
+    m9 = get32u_be(m + 36);
+    ma = get32u_be(m + 40);
+    mb = get32u_be(m + 44);
+    mc = get32u_be(m + 48);
+    md = get32u_be(m + 52);
+    me = get32u_be(m + 56);
+    mf = get32u_be(m + 60);
+
+    kp = sha2_256_k;
+    STEP_SHA256_R(e, f, g, h, a, b, c, d, m4, kp[4]); /* rounds 4..15 */
     STEP_SHA256_R(d, e, f, g, h, a, b, c, m5, kp[5]);
     STEP_SHA256_R(c, d, e, f, g, h, a, b, m6, kp[6]);
     STEP_SHA256_R(b, c, d, e, f, g, h, a, m7, kp[7]);
@@ -106,38 +349,87 @@ void sha2_256_compress(void *v)
     STEP_SHA256_R(c, d, e, f, g, h, a, b, me, kp[14]);
     STEP_SHA256_R(b, c, d, e, f, g, h, a, mf, kp[15]);
 
-    if (kp == &ck[64 - 16])
+    do
+    {
+      kp += 16;
+
+      STEP_SHA256_K(m0, m1, m9, me); /* message schedule */
+      STEP_SHA256_K(m1, m2, ma, mf);
+      STEP_SHA256_K(m2, m3, mb, m0);
+      STEP_SHA256_K(m3, m4, mc, m1);
+      STEP_SHA256_K(m4, m5, md, m2);
+      STEP_SHA256_K(m5, m6, me, m3);
+      STEP_SHA256_K(m6, m7, mf, m4);
+      STEP_SHA256_K(m7, m8, m0, m5);
+      STEP_SHA256_K(m8, m9, m1, m6);
+      STEP_SHA256_K(m9, ma, m2, m7);
+      STEP_SHA256_K(ma, mb, m3, m8);
+      STEP_SHA256_K(mb, mc, m4, m9);
+      STEP_SHA256_K(mc, md, m5, ma);
+      STEP_SHA256_K(md, me, m6, mb);
+      STEP_SHA256_K(me, mf, m7, mc);
+      STEP_SHA256_K(mf, m0, m8, md);
+
+      STEP_SHA256_R(a, b, c, d, e, f, g, h, m0, kp[0]); /* rounds */
+      STEP_SHA256_R(h, a, b, c, d, e, f, g, m1, kp[1]);
+      STEP_SHA256_R(g, h, a, b, c, d, e, f, m2, kp[2]);
+      STEP_SHA256_R(f, g, h, a, b, c, d, e, m3, kp[3]);
+      STEP_SHA256_R(e, f, g, h, a, b, c, d, m4, kp[4]);
+      STEP_SHA256_R(d, e, f, g, h, a, b, c, m5, kp[5]);
+      STEP_SHA256_R(c, d, e, f, g, h, a, b, m6, kp[6]);
+      STEP_SHA256_R(b, c, d, e, f, g, h, a, m7, kp[7]);
+      STEP_SHA256_R(a, b, c, d, e, f, g, h, m8, kp[8]);
+      STEP_SHA256_R(h, a, b, c, d, e, f, g, m9, kp[9]);
+      STEP_SHA256_R(g, h, a, b, c, d, e, f, ma, kp[10]);
+      STEP_SHA256_R(f, g, h, a, b, c, d, e, mb, kp[11]);
+      STEP_SHA256_R(e, f, g, h, a, b, c, d, mc, kp[12]);
+      STEP_SHA256_R(d, e, f, g, h, a, b, c, md, kp[13]);
+      STEP_SHA256_R(c, d, e, f, g, h, a, b, me, kp[14]);
+      STEP_SHA256_R(b, c, d, e, f, g, h, a, mf, kp[15]);
+    } while (kp != &sha2_256_k[64 - 16]);
+
+    put32u_be(buf, s[0] + a);
+    put32u_be(buf + 4, s[1] + b);
+    put32u_be(buf + 8, s[2] + c);
+    put32u_be(buf + 12, s[3] + d);
+    put32u_be(buf + 16, s[4] + e);
+    put32u_be(buf + 20, s[5] + f);
+    put32u_be(buf + 24, s[6] + g);
+    put32u_be(buf + 28, s[7] + h);
+
+    if (--nstep == 0)
     {
       break;
     }
-    kp += 16;
-
-    STEP_SHA256_K(m0, m1, m9, me); /* message schedule */
-    STEP_SHA256_K(m1, m2, ma, mf);
-    STEP_SHA256_K(m2, m3, mb, m0);
-    STEP_SHA256_K(m3, m4, mc, m1);
-    STEP_SHA256_K(m4, m5, md, m2);
-    STEP_SHA256_K(m5, m6, me, m3);
-    STEP_SHA256_K(m6, m7, mf, m4);
-    STEP_SHA256_K(m7, m8, m0, m5);
-    STEP_SHA256_K(m8, m9, m1, m6);
-    STEP_SHA256_K(m9, ma, m2, m7);
-    STEP_SHA256_K(ma, mb, m3, m8);
-    STEP_SHA256_K(mb, mc, m4, m9);
-    STEP_SHA256_K(mc, md, m5, ma);
-    STEP_SHA256_K(md, me, m6, mb);
-    STEP_SHA256_K(me, mf, m7, mc);
-    STEP_SHA256_K(mf, m0, m8, md);
+
+    /* feed back, increment counter */
+    memcpy(m + off, buf, n);
+    put32u_be(m + off - 4, get32u_be(m + off - 4) + 1);
   }
 
-  sp[0] = rev8_be32(sp[0] + a);
-  sp[1] = rev8_be32(sp[1] + b);
-  sp[2] = rev8_be32(sp[2] + c);
-  sp[3] = rev8_be32(sp[3] + d);
-  sp[4] = rev8_be32(sp[4] + e);
-  sp[5] = rev8_be32(sp[5] + f);
-  sp[6] = rev8_be32(sp[6] + g);
-  sp[7] = rev8_be32(sp[7] + h);
+  memcpy(y, buf, n);
+}
+
+/* "nstep" compressions of the block "m" from the state "iv", feeding */
+/* the first "n" bytes of each digest back into the block at "off" and */
+/* incrementing the big-endian counter word before it; output to "y" */
+
+void sha2_256_chain_blocks(uint8_t *y, const void *iv, uint8_t *m,
+                           size_t off, size_t n, size_t nstep)
+{
+#ifdef SLH_EXPERIMENTAL
+  sha2_256_compress_count += nstep; /* instrumentation */
+#endif
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_SHA)
+  {
+    sha2_256_chain_blocks_shani(y, iv, m, off, n, nstep);
+    return;
+  }
+#endif
+
+  sha2_256_chain_blocks_c(y, iv, m, off, n, nstep);
 }
 
 /* initialize */
@@ -207,12 +499,12 @@ void sha2_256_update(sha2_256_t *sha, const uint8_t *m, size_t m_sz)
     m += l;
     sha->i = 0;
   }
-  while (m_sz >= 64)
+  l = m_sz / 64; /* whole blocks, compressed in place */
+  if (l > 0)
   {
-    memcpy(mp, m, 64);
-    sha2_256_compress(sha->s);
-    m_sz -= 64;
-    m += 64;
+    sha2_256_compress_blocks(sha->s, m, l);
+    m += 64 * l;
+    m_sz -= 64 * l;
   }
   memcpy(mp, m, m_sz);
   sha->i = m_sz;
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === FIPS 180-4 SHA2-256 / x86-64 AVX2 8-lane multi-buffer compression */
+
+#include "plat_local.h"
+#include "sha2_api.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <immintrin.h>
+
+#define SHA2_256_AVX2 __attribute__((target("avx2")))
+
+/* vector helpers: each 32-bit lane belongs to a different message */
+
+#define V8_ADD(x, y) _mm256_add_epi32(x, y)
+#define V8_XOR(x, y) _mm256_xor_si256(x, y)
+#define V8_AND(x, y) _mm256_and_si256(x, y)
+#define V8_OR(x, y) _mm256_or_si256(x, y)
+#define V8_ROR(x, n) \
+  _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+/* processing step, sets "d" and "h" as a function of all 8 inputs */
+/* and message schedule "mi", round constant "ki" */
+#define STEP_SHA256_R8(a, b, c, d, e, f, g, h, mi, ki)                       \
+  {                                                                          \
+    h = V8_ADD(h, V8_ADD(V8_XOR(g, V8_AND(e, V8_XOR(f, g))),                 \
+                         V8_ADD(V8_ADD(mi, _mm256_set1_epi32(ki)),           \
+                                V8_XOR(V8_XOR(V8_ROR(e, 6), V8_ROR(e, 11)),  \
+                                       V8_ROR(e, 25)))));                    \
+    d = V8_ADD(d, h);                                                        \
+    h = V8_ADD(h, V8_ADD(V8_OR(V8_AND(V8_OR(a, c), b), V8_AND(c, a)),        \
+                         V8_XOR(V8_XOR(V8_ROR(a, 2), V8_ROR(a, 13)),         \
+                                V8_ROR(a, 22))));                            \
+  }
+
+/* keying step, sets x0 as a function of 4 inputs */
+#define STEP_SHA256_K8(x0, x1, x9, xe)                                       \
+  {                                                                          \
+    x0 = V8_ADD(                                                             \
+        V8_ADD(x0, x9),                                                      \
+        V8_ADD(V8_XOR(V8_XOR(V8_ROR(x1, 7), V8_ROR(x1, 18)),                 \
+                      _mm256_srli_epi32(x1, 3)),                             \
+               V8_XOR(V8_XOR(V8_ROR(xe, 17), V8_ROR(xe, 19)),                \
+                      _mm256_srli_epi32(xe, 10))));                          \
+  }
+
+/* 8x8 transpose of 32-bit words; rows become columns */
+
+SHA2_256_AVX2
+static void sha2_256_tr8(__m256i r[8])
+{
+  __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+  __m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+  t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+  t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+  t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+  t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+  t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+  t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+  t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+  t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+  u0 = _mm256_unpacklo_epi64(t0, t2);
+  u1 = _mm256_unpackhi_epi64(t0, t2);
+  u2 = _mm256_unpacklo_epi64(t1, t3);
+  u3 = _mm256_unpackhi_epi64(t1, t3);
+  u4 = _mm256_unpacklo_epi64(t4, t6);
+  u5 = _mm256_unpackhi_epi64(t4, t6);
+  u6 = _mm256_unpacklo_epi64(t5, t7);
+  u7 = _mm256_unpackhi_epi64(t5, t7);
+
+  r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* load eight 32-byte rows at offset "off", byte reverse, transpose */
+
+SHA2_256_AVX2
+static void sha2_256_ld8(__m256i r[8], void *v[8], size_t off)
+{
+  const __m256i bswap = _mm256_set_epi8(
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8,
+      9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  int i;
+
+  for (i = 0; i < 8; i++)
+  {
+    r[i] = _mm256_shuffle_epi8(
+        _mm256_loadu_si256((const __m256i *)((uint8_t *)v[i] + off)),
+        bswap);
+  }
+  sha2_256_tr8(r);
+}
+
+/* eight independent compression functions; v[i] as in sha2_256_compress() */
+
+SHA2_256_AVX2
+void sha2_256_compress_x8_avx2(void *v[8])
+{
+  const __m256i bswap = _mm256_set_epi8(
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8,
+      9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  const uint32_t *kp = sha2_256_k;
+  __m256i s[8], m[16];
+  __m256i a, b, c, d, e, f, g, h;
+  __m256i m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, ma, mb, mc, md, me, mf;
+  int i;
+
+  /* get state and message, one message per 32-bit lane */
+  sha2_256_ld8(s, v, 0);
+  sha2_256_ld8(m, v, 32);
+  sha2_256_ld8(m + 8, v, 64);
+
+  a = s[0];
+  b = s[1];
+  c = s[2];
+  d = s[3];
+  e = s[4];
+  f = s[5];
+  g = s[6];
+  h = s[7];
+
+  m0 = m[0];
+  m1 = m[1];
+  m2 = m[2];
+  m3 = m[3];
+  m4 = m[4];
+  m5 = m[5];
+  m6 = m[6];
+  m7 = m[7];
+  m8 = m[8];
+  m9 = m[9];
+  ma = m[10];
+  mb = m[11];
+  mc = m[12];
+  md = m[13];
+  me = m[14];
+  mf = m[15];
+
+  while (1)
+  {
+    STEP_SHA256_R8(a, b, c, d, e, f, g, h, m0, kp[0]); /* rounds */
+    STEP_SHA256_R8(h, a, b, c, d, e, f, g, m1, kp[1]);
+    STEP_SHA256_R8(g, h, a, b, c, d, e, f, m2, kp[2]);
+    STEP_SHA256_R8(f, g, h, a, b, c, d, e, m3, kp[3]);
+    STEP_SHA256_R8(e, f, g, h, a, b, c, d, m4, kp[4]);
+    STEP_SHA256_R8(d, e, f, g, h, a, b, c, m5, kp[5]);
+    STEP_SHA256_R8(c, d, e, f, g, h, a, b, m6, kp[6]);
+    STEP_SHA256_R8(b, c, d, e, f, g, h, a, m7, kp[7]);
+    STEP_SHA256_R8(a, b, c, d, e, f, g, h, m8, kp[8]);
+    STEP_SHA256_R8(h, a, b, c, d, e, f, g, m9, kp[9]);
+    STEP_SHA256_R8(g, h, a, b, c, d, e, f, ma, kp[10]);
+    STEP_SHA256_R8(f, g, h, a, b, c, d, e, mb, kp[11]);
+    STEP_SHA256_R8(e, f, g, h, a, b, c, d, mc, kp[12]);
+    STEP_SHA256_R8(d, e, f, g, h, a, b, c, md, kp[13]);
+    STEP_SHA256_R8(c, d, e, f, g, h, a, b, me, kp[14]);
+    STEP_SHA256_R8(b, c, d, e, f, g, h, a, mf, kp[15]);
+
+    if (kp == &sha2_256_k[64 - 16])
+    {
+      break;
+    }
+    kp += 16;
+
+    STEP_SHA256_K8(m0, m1, m9, me); /* message schedule */
+    STEP_SHA256_K8(m1, m2, ma, mf);
+    STEP_SHA256_K8(m2, m3, mb, m0);
+    STEP_SHA256_K8(m3, m4, mc, m1);
+    STEP_SHA256_K8(m4, m5, md, m2);
+    STEP_SHA256_K8(m5, m6, me, m3);
+    STEP_SHA256_K8(m6, m7, mf, m4);
+    STEP_SHA256_K8(m7, m8, m0, m5);
+    STEP_SHA256_K8(m8, m9, m1, m6);
+    STEP_SHA256_K8(m9, ma, m2, m7);
+    STEP_SHA256_K8(ma, mb, m3, m8);
+    STEP_SHA256_K8(mb, mc, m4, m9);
+    STEP_SHA256_K8(mc, md, m5, ma);
+    STEP_SHA256_K8(md, me, m6, mb);
+    STEP_SHA256_K8(me, mf, m7, mc);
+    STEP_SHA256_K8(mf, m0, m8, md);
+  }
+
+  s[0] = V8_ADD(s[0], a);
+  s[1] = V8_ADD(s[1], b);
+  s[2] = V8_ADD(s[2], c);
+  s[3] = V8_ADD(s[3], d);
+  s[4] = V8_ADD(s[4], e);
+  s[5] = V8_ADD(s[5], f);
+  s[6] = V8_ADD(s[6], g);
+  s[7] = V8_ADD(s[7], h);
+
+  /* transpose back to one state per row, store big-endian */
+  sha2_256_tr8(s);
+  for (i = 0; i < 8; i++)
+  {
+    _mm256_storeu_si256((__m256i *)v[i], _mm256_shuffle_epi8(s[i], bswap));
+  }
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(sha2_256_avx2)
+
+#endif /* PLAT_X64_SIMD */
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === FIPS 180-4 SHA2-256 / x86-64 SHA Extensions (SHA-NI) */
+
+#include <string.h>
+#include "plat_local.h"
+#include "sha2_api.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <immintrin.h>
+
+#define SHA2_256_SHANI __attribute__((target("sha,ssse3,sse4.1")))
+
+/* four rounds with message words w; the state is kept as (ABEF, CDGH) */
+#define SHANI_RNDS4(w, i)                                                 \
+  {                                                                       \
+    t = _mm_add_epi32(w, _mm_loadu_si128((const __m128i *)&kp[4 * (i)])); \
+    s1 = _mm_sha256rnds2_epu32(s1, s0, t);                                \
+    t = _mm_shuffle_epi32(t, 0x0E);                                       \
+    s0 = _mm_sha256rnds2_epu32(s0, s1, t);                                \
+  }
+
+/* four rounds, also completing the schedule of w4 (the next quad) */
+#define SHANI_RNDS4_MSG2(w, w3, w4, i)                                    \
+  {                                                                       \
+    t = _mm_add_epi32(w, _mm_loadu_si128((const __m128i *)&kp[4 * (i)])); \
+    s1 = _mm_sha256rnds2_epu32(s1, s0, t);                                \
+    w4 = _mm_add_epi32(w4, _mm_alignr_epi8(w, w3, 4));                    \
+    w4 = _mm_sha256msg2_epu32(w4, w);                                     \
+    t = _mm_shuffle_epi32(t, 0x0E);                                       \
+    s0 = _mm_sha256rnds2_epu32(s0, s1, t);                                \
+  }
+
+SHA2_256_SHANI
+void sha2_256_compress_blocks_shani(void *s, const uint8_t *m, size_t nblk)
+{
+  const __m128i bswap =
+      _mm_set_epi64x(0x0C0D0E0F08090A0BLL, 0x0405060700010203LL);
+  uint8_t *sp = (uint8_t *)s;
+  const uint32_t *kp;
+  __m128i s0, s1, h0, h1, t;
+  __m128i w0, w1, w2, w3;
+
+  /* big-endian state words -> (ABEF, CDGH) */
+  t = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)sp), bswap);
+  s1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(sp + 16)), bswap);
+  t = _mm_shuffle_epi32(t, 0xB1);  /* CDAB */
+  s1 = _mm_shuffle_epi32(s1, 0x1B); /* EFGH */
+  s0 = _mm_alignr_epi8(t, s1, 8);   /* ABEF */
+  s1 = _mm_blend_epi16(s1, t, 0xF0); /* CDGH */
+
+  for (; nblk > 0; nblk--)
+  {
+    h0 = s0;
+    h1 = s1;
+    kp = sha2_256_k;
+
+    /* load and reverse bytes */
+    w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)m), bswap);
+    w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 16)), bswap);
+    w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 32)), bswap);
+    w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 48)), bswap);
+
+    SHANI_RNDS4(w0, 0);
+    SHANI_RNDS4(w1, 1);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4(w2, 2);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 3);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 4);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 5);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 6);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 7);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 8);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 9);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 10);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 11);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 12);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 13);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 14);
+    SHANI_RNDS4(w3, 15);
+
+    s0 = _mm_add_epi32(s0, h0);
+    s1 = _mm_add_epi32(s1, h1);
+    m += 64;
+  }
+
+  /* (ABEF, CDGH) -> big-endian state words */
+  t = _mm_shuffle_epi32(s0, 0x1B);  /* FEBA */
+  s1 = _mm_shuffle_epi32(s1, 0xB1); /* DCHG */
+  s0 = _mm_blend_epi16(t, s1, 0xF0); /* DCBA */
+  s1 = _mm_alignr_epi8(s1, t, 8);    /* HGFE */
+  _mm_storeu_si128((__m128i *)sp, _mm_shuffle_epi8(s0, bswap));
+  _mm_storeu_si128((__m128i *)(sp + 16), _mm_shuffle_epi8(s1, bswap));
+}
+
+/* hash chain as in sha2_256_chain_blocks(); the first four rounds only */
+/* depend on the fixed block words 0..3 and are computed once */
+
+SHA2_256_SHANI
+void sha2_256_chain_blocks_shani(uint8_t *y, const void *iv, uint8_t *m,
+                                 size_t off, size_t n, size_t nstep)
+{
+  const __m128i bswap =
+      _mm_set_epi64x(0x0C0D0E0F08090A0BLL, 0x0405060700010203LL);
+  const uint8_t *sp = (const uint8_t *)iv;
+  const uint32_t *kp = sha2_256_k;
+  uint8_t buf[32];
+  __m128i s0, s1, h0, h1, r0, r1, t;
+  __m128i c0, w0, w1, w2, w3;
+
+  /* big-endian state words -> (ABEF, CDGH) */
+  t = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)sp), bswap);
+  s1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(sp + 16)), bswap);
+  t = _mm_shuffle_epi32(t, 0xB1);  /* CDAB */
+  s1 = _mm_shuffle_epi32(s1, 0x1B); /* EFGH */
+  s0 = _mm_alignr_epi8(t, s1, 8);   /* ABEF */
+  s1 = _mm_blend_epi16(s1, t, 0xF0); /* CDGH */
+  h0 = s0;
+  h1 = s1;
+
+  /* rounds 0..3 are the same for every step */
+  c0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)m), bswap);
+  SHANI_RNDS4(c0, 0);
+  r0 = s0;
+  r1 = s1;
+
+  while (1)
+  {
+    s0 = r0;
+    s1 = r1;
+
+    w0 = c0;
+    w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 16)), bswap);
+    w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 32)), bswap);
+    w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(m + 48)), bswap);
+
+    SHANI_RNDS4(w1, 1);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4(w2, 2);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 3);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 4);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 5);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 6);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 7);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 8);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 9);
+    w0 = _mm_sha256msg1_epu32(w0, w1);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 10);
+    w1 = _mm_sha256msg1_epu32(w1, w2);
+    SHANI_RNDS4_MSG2(w3, w2, w0, 11);
+    w2 = _mm_sha256msg1_epu32(w2, w3);
+
+    SHANI_RNDS4_MSG2(w0, w3, w1, 12);
+    w3 = _mm_sha256msg1_epu32(w3, w0);
+    SHANI_RNDS4_MSG2(w1, w0, w2, 13);
+    SHANI_RNDS4_MSG2(w2, w1, w3, 14);
+    SHANI_RNDS4(w3, 15);
+
+    s0 = _mm_add_epi32(s0, h0);
+    s1 = _mm_add_epi32(s1, h1);
+
+    /* (ABEF, CDGH) -> big-endian digest */
+    t = _mm_shuffle_epi32(s0, 0x1B);  /* FEBA */
+    s1 = _mm_shuffle_epi32(s1, 0xB1); /* DCHG */
+    s0 = _mm_blend_epi16(t, s1, 0xF0); /* DCBA */
+    s1 = _mm_alignr_epi8(s1, t, 8);    /* HGFE */
+    _mm_storeu_si128((__m128i *)buf, _mm_shuffle_epi8(s0, bswap));
+    _mm_storeu_si128((__m128i *)(buf + 16), _mm_shuffle_epi8(s1, bswap));
+
+    if (--nstep == 0)
+    {
+      break;
+    }
+
+    /* feed back, increment counter */
+    memcpy(m + off, buf, n);
+    put32u_be(m + off - 4, get32u_be(m + off - 4) + 1);
+  }
+
+  memcpy(y, buf, n);
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(sha2_256_shani)
+
+#endif /* PLAT_X64_SIMD */
@@ -31,146 +31,252 @@ uint64_t sha2_512_compress_count = 0; /* instrumentation */
           (ror64(xe, 19) ^ ror64(xe, 61) ^ (xe >> 6));     \
   }
 
-/* compression function (this one does *not* modify m[16]) */
-
-void sha2_512_compress(void *v)
+/* 4.2.3 SHA-384, SHA-512, SHA-512/224 and SHA-512/256 Constants */
+
+const uint64_t sha2_512_k[80] = {
+    UINT64_C(0x428A2F98D728AE22), UINT64_C(0x7137449123EF65CD),
+    UINT64_C(0xB5C0FBCFEC4D3B2F), UINT64_C(0xE9B5DBA58189DBBC),
+    UINT64_C(0x3956C25BF348B538), UINT64_C(0x59F111F1B605D019),
+    UINT64_C(0x923F82A4AF194F9B), UINT64_C(0xAB1C5ED5DA6D8118),
+    UINT64_C(0xD807AA98A3030242), UINT64_C(0x12835B0145706FBE),
+    UINT64_C(0x243185BE4EE4B28C), UINT64_C(0x550C7DC3D5FFB4E2),
+    UINT64_C(0x72BE5D74F27B896F), UINT64_C(0x80DEB1FE3B1696B1),
+    UINT64_C(0x9BDC06A725C71235), UINT64_C(0xC19BF174CF692694),
+    UINT64_C(0xE49B69C19EF14AD2), UINT64_C(0xEFBE4786384F25E3),
+    UINT64_C(0x0FC19DC68B8CD5B5), UINT64_C(0x240CA1CC77AC9C65),
+    UINT64_C(0x2DE92C6F592B0275), UINT64_C(0x4A7484AA6EA6E483),
+    UINT64_C(0x5CB0A9DCBD41FBD4), UINT64_C(0x76F988DA831153B5),
+    UINT64_C(0x983E5152EE66DFAB), UINT64_C(0xA831C66D2DB43210),
+    UINT64_C(0xB00327C898FB213F), UINT64_C(0xBF597FC7BEEF0EE4),
+    UINT64_C(0xC6E00BF33DA88FC2), UINT64_C(0xD5A79147930AA725),
+    UINT64_C(0x06CA6351E003826F), UINT64_C(0x142929670A0E6E70),
+    UINT64_C(0x27B70A8546D22FFC), UINT64_C(0x2E1B21385C26C926),
+    UINT64_C(0x4D2C6DFC5AC42AED), UINT64_C(0x53380D139D95B3DF),
+    UINT64_C(0x650A73548BAF63DE), UINT64_C(0x766A0ABB3C77B2A8),
+    UINT64_C(0x81C2C92E47EDAEE6), UINT64_C(0x92722C851482353B),
+    UINT64_C(0xA2BFE8A14CF10364), UINT64_C(0xA81A664BBC423001),
+    UINT64_C(0xC24B8B70D0F89791), UINT64_C(0xC76C51A30654BE30),
+    UINT64_C(0xD192E819D6EF5218), UINT64_C(0xD69906245565A910),
+    UINT64_C(0xF40E35855771202A), UINT64_C(0x106AA07032BBD1B8),
+    UINT64_C(0x19A4C116B8D2D0C8), UINT64_C(0x1E376C085141AB53),
+    UINT64_C(0x2748774CDF8EEB99), UINT64_C(0x34B0BCB5E19B48A8),
+    UINT64_C(0x391C0CB3C5C95A63), UINT64_C(0x4ED8AA4AE3418ACB),
+    UINT64_C(0x5B9CCA4F7763E373), UINT64_C(0x682E6FF3D6B2B8A3),
+    UINT64_C(0x748F82EE5DEFB2FC), UINT64_C(0x78A5636F43172F60),
+    UINT64_C(0x84C87814A1F0AB72), UINT64_C(0x8CC702081A6439EC),
+    UINT64_C(0x90BEFFFA23631E28), UINT64_C(0xA4506CEBDE82BDE9),
+    UINT64_C(0xBEF9A3F7B2C67915), UINT64_C(0xC67178F2E372532B),
+    UINT64_C(0xCA273ECEEA26619C), UINT64_C(0xD186B8C721C0C207),
+    UINT64_C(0xEADA7DD6CDE0EB1E), UINT64_C(0xF57D4F7FEE6ED178),
+    UINT64_C(0x06F067AA72176FBA), UINT64_C(0x0A637DC5A2C898A6),
+    UINT64_C(0x113F9804BEF90DAE), UINT64_C(0x1B710B35131C471B),
+    UINT64_C(0x28DB77F523047D84), UINT64_C(0x32CAAB7B40C72493),
+    UINT64_C(0x3C9EBE0A15C9BEBC), UINT64_C(0x431D67C49C100D4C),
+    UINT64_C(0x4CC5D4BECB3E42B6), UINT64_C(0x597F299CFC657E2A),
+    UINT64_C(0x5FCB6FAB3AD6FAEC), UINT64_C(0x6C44198C4A475817)};
+
+/* compress "nblk" consecutive 128-byte blocks from "m" directly into the */
+/* state "s" (the message is not modified) */
+
+void sha2_512_compress_blocks(void *s, const uint8_t *m, size_t nblk)
 {
-  /* 4.2.3 SHA-384, SHA-512, SHA-512/224 and SHA-512/256 Constants */
-
-  const uint64_t ck[80] = {
-      UINT64_C(0x428A2F98D728AE22), UINT64_C(0x7137449123EF65CD),
-      UINT64_C(0xB5C0FBCFEC4D3B2F), UINT64_C(0xE9B5DBA58189DBBC),
-      UINT64_C(0x3956C25BF348B538), UINT64_C(0x59F111F1B605D019),
-      UINT64_C(0x923F82A4AF194F9B), UINT64_C(0xAB1C5ED5DA6D8118),
-      UINT64_C(0xD807AA98A3030242), UINT64_C(0x12835B0145706FBE),
-      UINT64_C(0x243185BE4EE4B28C), UINT64_C(0x550C7DC3D5FFB4E2),
-      UINT64_C(0x72BE5D74F27B896F), UINT64_C(0x80DEB1FE3B1696B1),
-      UINT64_C(0x9BDC06A725C71235), UINT64_C(0xC19BF174CF692694),
-      UINT64_C(0xE49B69C19EF14AD2), UINT64_C(0xEFBE4786384F25E3),
-      UINT64_C(0x0FC19DC68B8CD5B5), UINT64_C(0x240CA1CC77AC9C65),
-      UINT64_C(0x2DE92C6F592B0275), UINT64_C(0x4A7484AA6EA6E483),
-      UINT64_C(0x5CB0A9DCBD41FBD4), UINT64_C(0x76F988DA831153B5),
-      UINT64_C(0x983E5152EE66DFAB), UINT64_C(0xA831C66D2DB43210),
-      UINT64_C(0xB00327C898FB213F), UINT64_C(0xBF597FC7BEEF0EE4),
-      UINT64_C(0xC6E00BF33DA88FC2), UINT64_C(0xD5A79147930AA725),
-      UINT64_C(0x06CA6351E003826F), UINT64_C(0x142929670A0E6E70),
-      UINT64_C(0x27B70A8546D22FFC), UINT64_C(0x2E1B21385C26C926),
-      UINT64_C(0x4D2C6DFC5AC42AED), UINT64_C(0x53380D139D95B3DF),
-      UINT64_C(0x650A73548BAF63DE), UINT64_C(0x766A0ABB3C77B2A8),
-      UINT64_C(0x81C2C92E47EDAEE6), UINT64_C(0x92722C851482353B),
-      UINT64_C(0xA2BFE8A14CF10364), UINT64_C(0xA81A664BBC423001),
-      UINT64_C(0xC24B8B70D0F89791), UINT64_C(0xC76C51A30654BE30),
-      UINT64_C(0xD192E819D6EF5218), UINT64_C(0xD69906245565A910),
-      UINT64_C(0xF40E35855771202A), UINT64_C(0x106AA07032BBD1B8),
-      UINT64_C(0x19A4C116B8D2D0C8), UINT64_C(0x1E376C085141AB53),
-      UINT64_C(0x2748774CDF8EEB99), UINT64_C(0x34B0BCB5E19B48A8),
-      UINT64_C(0x391C0CB3C5C95A63), UINT64_C(0x4ED8AA4AE3418ACB),
-      UINT64_C(0x5B9CCA4F7763E373), UINT64_C(0x682E6FF3D6B2B8A3),
-      UINT64_C(0x748F82EE5DEFB2FC), UINT64_C(0x78A5636F43172F60),
-      UINT64_C(0x84C87814A1F0AB72), UINT64_C(0x8CC702081A6439EC),
-      UINT64_C(0x90BEFFFA23631E28), UINT64_C(0xA4506CEBDE82BDE9),
-      UINT64_C(0xBEF9A3F7B2C67915), UINT64_C(0xC67178F2E372532B),
-      UINT64_C(0xCA273ECEEA26619C), UINT64_C(0xD186B8C721C0C207),
-      UINT64_C(0xEADA7DD6CDE0EB1E), UINT64_C(0xF57D4F7FEE6ED178),
-      UINT64_C(0x06F067AA72176FBA), UINT64_C(0x0A637DC5A2C898A6),
-      UINT64_C(0x113F9804BEF90DAE), UINT64_C(0x1B710B35131C471B),
-      UINT64_C(0x28DB77F523047D84), UINT64_C(0x32CAAB7B40C72493),
-      UINT64_C(0x3C9EBE0A15C9BEBC), UINT64_C(0x431D67C49C100D4C),
-      UINT64_C(0x4CC5D4BECB3E42B6), UINT64_C(0x597F299CFC657E2A),
-      UINT64_C(0x5FCB6FAB3AD6FAEC), UINT64_C(0x6C44198C4A475817)};
-
   uint64_t a, b, c, d, e, f, g, h;
   uint64_t m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, ma, mb, mc, md, me, mf;
 
-  uint64_t *sp = (uint64_t *)v;
-  const uint64_t *mp = sp + 8;
-  const uint64_t *kp = ck;
+  uint64_t *sp = (uint64_t *)s;
+  const uint64_t *kp;
 
 #ifdef SLH_EXPERIMENTAL
-  sha2_512_compress_count++; /* instrumentation */
+  sha2_512_compress_count += nblk; /* instrumentation */
 #endif
 
   /* get state */
-  a = sp[0] = rev8_be64(sp[0]);
-  b = sp[1] = rev8_be64(sp[1]);
-  c = sp[2] = rev8_be64(sp[2]);
-  d = sp[3] = rev8_be64(sp[3]);
-  e = sp[4] = rev8_be64(sp[4]);
-  f = sp[5] = rev8_be64(sp[5]);
-  g = sp[6] = rev8_be64(sp[6]);
-  h = sp[7] = rev8_be64(sp[7]);
-
-  /* load and reverse bytes (if needed) */
-
-  m0 = rev8_be64(mp[0]);
-  m1 = rev8_be64(mp[1]);
-  m2 = rev8_be64(mp[2]);
-  m3 = rev8_be64(mp[3]);
-  m4 = rev8_be64(mp[4]);
-  m5 = rev8_be64(mp[5]);
-  m6 = rev8_be64(mp[6]);
-  m7 = rev8_be64(mp[7]);
-  m8 = rev8_be64(mp[8]);
-  m9 = rev8_be64(mp[9]);
-  ma = rev8_be64(mp[10]);
-  mb = rev8_be64(mp[11]);
-  mc = rev8_be64(mp[12]);
-  md = rev8_be64(mp[13]);
-  me = rev8_be64(mp[14]);
-  mf = rev8_be64(mp[15]);
-
-  while (1)
+  sp[0] = rev8_be64(sp[0]);
+  sp[1] = rev8_be64(sp[1]);
+  sp[2] = rev8_be64(sp[2]);
+  sp[3] = rev8_be64(sp[3]);
+  sp[4] = rev8_be64(sp[4]);
+  sp[5] = rev8_be64(sp[5]);
+  sp[6] = rev8_be64(sp[6]);
+  sp[7] = rev8_be64(sp[7]);
+
+  for (; nblk > 0; nblk--)
   {
-    /* main rounds */
-    STEP_SHA512_R(a, b, c, d, e, f, g, h, m0, kp[0]);
-    STEP_SHA512_R(h, a, b, c, d, e, f, g, m1, kp[1]);
-    STEP_SHA512_R(g, h, a, b, c, d, e, f, m2, kp[2]);
-    STEP_SHA512_R(f, g, h, a, b, c, d, e, m3, kp[3]);
-    STEP_SHA512_R(e, f, g, h, a, b, c, d, m4, kp[4]);
-    STEP_SHA512_R(d, e, f, g, h, a, b, c, m5, kp[5]);
-    STEP_SHA512_R(c, d, e, f, g, h, a, b, m6, kp[6]);
-    STEP_SHA512_R(b, c, d, e, f, g, h, a, m7, kp[7]);
-    STEP_SHA512_R(a, b, c, d, e, f, g, h, m8, kp[8]);
-    STEP_SHA512_R(h, a, b, c, d, e, f, g, m9, kp[9]);
-    STEP_SHA512_R(g, h, a, b, c, d, e, f, ma, kp[10]);
-    STEP_SHA512_R(f, g, h, a, b, c, d, e, mb, kp[11]);
-    STEP_SHA512_R(e, f, g, h, a, b, c, d, mc, kp[12]);
-    STEP_SHA512_R(d, e, f, g, h, a, b, c, md, kp[13]);
-    STEP_SHA512_R(c, d, e, f, g, h, a, b, me, kp[14]);
-    STEP_SHA512_R(b, c, d, e, f, g, h, a, mf, kp[15]);
-
-    if (kp == &ck[80 - 16])
+    a = sp[0];
+    b = sp[1];
+    c = sp[2];
+    d = sp[3];
+    e = sp[4];
+    f = sp[5];
+    g = sp[6];
+    h = sp[7];
+
+    /* load big-endian message words */
+
+    m0 = get64u_be(m);
+    m1 = get64u_be(m + 8);
+    m2 = get64u_be(m + 16);
+    m3 = get64u_be(m + 24);
+    m4 = get64u_be(m + 32);
+    m5 = get64u_be(m + 40);
+    m6 = get64u_be(m + 48);
+    m7 = get64u_be(m + 56);
+    m8 = get64u_be(m + 64);
+    m9 = get64u_be(m + 72);
+    ma = get64u_be(m + 80);
+    mb = get64u_be(m + 88);
+    mc = get64u_be(m + 96);
+    md = get64u_be(m + 104);
+    me = get64u_be(m + 112);
+    mf = get64u_be(m + 120);
+    m += 128;
+
+    kp = sha2_512_k;
+    while (1)
     {
-      break;
+      /* main rounds */
+      STEP_SHA512_R(a, b, c, d, e, f, g, h, m0, kp[0]);
+      STEP_SHA512_R(h, a, b, c, d, e, f, g, m1, kp[1]);
+      STEP_SHA512_R(g, h, a, b, c, d, e, f, m2, kp[2]);
+      STEP_SHA512_R(f, g, h, a, b, c, d, e, m3, kp[3]);
+      STEP_SHA512_R(e, f, g, h, a, b, c, d, m4, kp[4]);
+      STEP_SHA512_R(d, e, f, g, h, a, b, c, m5, kp[5]);
+      STEP_SHA512_R(c, d, e, f, g, h, a, b, m6, kp[6]);
+      STEP_SHA512_R(b, c, d, e, f, g, h, a, m7, kp[7]);
+      STEP_SHA512_R(a, b, c, d, e, f, g, h, m8, kp[8]);
+      STEP_SHA512_R(h, a, b, c, d, e, f, g, m9, kp[9]);
+      STEP_SHA512_R(g, h, a, b, c, d, e, f, ma, kp[10]);
+      STEP_SHA512_R(f, g, h, a, b, c, d, e, mb, kp[11]);
+      STEP_SHA512_R(e, f, g, h, a, b, c, d, mc, kp[12]);
+      STEP_SHA512_R(d, e, f, g, h, a, b, c, md, kp[13]);
+      STEP_SHA512_R(c, d, e, f, g, h, a, b, me, kp[14]);
+      STEP_SHA512_R(b, c, d, e, f, g, h, a, mf, kp[15]);
+
+      if (kp == &sha2_512_k[80 - 16])
+      {
+        break;
+      }
+      kp += 16;
+
+      STEP_SHA512_K(m0, m1, m9, me); /* key schedule */
+      STEP_SHA512_K(m1, m2, ma, mf);
+      STEP_SHA512_K(m2, m3, mb, m0);
+      STEP_SHA512_K(m3, m4, mc, m1);
+      STEP_SHA512_K(m4, m5, md, m2);
+      STEP_SHA512_K(m5, m6, me, m3);
+      STEP_SHA512_K(m6, m7, mf, m4);
+      STEP_SHA512_K(m7, m8, m0, m5);
+      STEP_SHA512_K(m8, m9, m1, m6);
+      STEP_SHA512_K(m9, ma, m2, m7);
+      STEP_SHA512_K(ma, mb, m3, m8);
+      STEP_SHA512_K(mb, mc, m4, m9);
+      STEP_SHA512_K(mc, md, m5, ma);
+      STEP_SHA512_K(md, me, m6, mb);
+      STEP_SHA512_K(me, mf, m7, mc);
+      STEP_SHA512_K(mf, m0, m8, md);
     }
-    kp += 16;
-
-    STEP_SHA512_K(m0, m1, m9, me); /* key schedule */
-    STEP_SHA512_K(m1, m2, ma, mf);
-    STEP_SHA512_K(m2, m3, mb, m0);
-    STEP_SHA512_K(m3, m4, mc, m1);
-    STEP_SHA512_K(m4, m5, md, m2);
-    STEP_SHA512_K(m5, m6, me, m3);
-    STEP_SHA512_K(m6, m7, mf, m4);
-    STEP_SHA512_K(m7, m8, m0, m5);
-    STEP_SHA512_K(m8, m9, m1, m6);
-    STEP_SHA512_K(m9, ma, m2, m7);
-    STEP_SHA512_K(ma, mb, m3, m8);
-    STEP_SHA512_K(mb, mc, m4, m9);
-    STEP_SHA512_K(mc, md, m5, ma);
-    STEP_SHA512_K(md, me, m6, mb);
-    STEP_SHA512_K(me, mf, m7, mc);
-    STEP_SHA512_K(mf, m0, m8, md);
+
+    sp[0] += a;
+    sp[1] += b;
+    sp[2] += c;
+    sp[3] += d;
+    sp[4] += e;
+    sp[5] += f;
+    sp[6] += g;
+    sp[7] += h;
   }
 
-  sp[0] = rev8_be64(sp[0] + a);
-  sp[1] = rev8_be64(sp[1] + b);
-  sp[2] = rev8_be64(sp[2] + c);
-  sp[3] = rev8_be64(sp[3] + d);
-  sp[4] = rev8_be64(sp[4] + e);
-  sp[5] = rev8_be64(sp[5] + f);
-  sp[6] = rev8_be64(sp[6] + g);
-  sp[7] = rev8_be64(sp[7] + h);
+  sp[0] = rev8_be64(sp[0]);
+  sp[1] = rev8_be64(sp[1]);
+  sp[2] = rev8_be64(sp[2]);
+  sp[3] = rev8_be64(sp[3]);
+  sp[4] = rev8_be64(sp[4]);
+  sp[5] = rev8_be64(sp[5]);
+  sp[6] = rev8_be64(sp[6]);
+  sp[7] = rev8_be64(sp[7]);
+}
+
+/* compression function; the block follows the state in "v" */
+
+void sha2_512_compress(void *v)
+{
+  sha2_512_compress_blocks(v, (const uint8_t *)v + 64, 1);
+}
+
+/* four independent compressions, using SIMD lanes if available. */
+/* Without them, only the lanes in "act" are computed */
+
+void sha2_512_compress_x4(void *v[4], uint32_t act)
+{
+  int i;
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_AVX2)
+  {
+#ifdef SLH_EXPERIMENTAL
+    for (i = 0; i < 4; i++)
+    {
+      sha2_512_compress_count += (act >> i) & 1; /* instrumentation */
+    }
+#endif
+    sha2_512_compress_x4_avx2(v);
+    return;
+  }
+#endif
+
+  for (i = 0; i < 4; i++)
+  {
+    if ((act >> i) & 1)
+    {
+      sha2_512_compress(v[i]);
+    }
+  }
+}
+
+/* eight independent compressions, using SIMD lanes if available */
+
+void sha2_512_compress_x8(void *v[8], uint32_t act)
+{
+#ifdef PLAT_X64_SIMD
+#ifdef SLH_EXPERIMENTAL
+  int i;
+#endif
+
+  if (plat_x64_features() & PLAT_X64_AVX512)
+  {
+#ifdef SLH_EXPERIMENTAL
+    for (i = 0; i < 8; i++)
+    {
+      sha2_512_compress_count += (act >> i) & 1; /* instrumentation */
+    }
+#endif
+    sha2_512_compress_x8_avx512(v);
+    return;
+  }
+#endif
+
+  sha2_512_compress_x4(v, act & 0xF);
+  sha2_512_compress_x4(v + 4, (act >> 4) & 0xF);
+}
+
+/* number of independent compressions worth batching per call: 8 or 4 */
+/* with the SIMD kernels, or 1 if single compressions are as fast */
+
+size_t sha2_512_lanes(void)
+{
+#ifdef PLAT_X64_SIMD
+  uint32_t f = plat_x64_features();
+
+  if (f & PLAT_X64_AVX512)
+  {
+    return 8;
+  }
+  if (f & PLAT_X64_AVX2)
+  {
+    return 4;
+  }
+#endif
+  return 1;
 }
 
 /* initialize */
@@ -269,12 +375,12 @@ void sha2_512_update(sha2_512_t *sha, const uint8_t *m, size_t m_sz)
     m += l;
     sha->i = 0;
   }
-  while (m_sz >= 128)
+  l = m_sz / 128; /* whole blocks, compressed in place */
+  if (l > 0)
   {
-    memcpy(mp, m, 128);
-    sha2_512_compress(sha->s);
-    m_sz -= 128;
-    m += 128;
+    sha2_512_compress_blocks(sha->s, m, l);
+    m += 128 * l;
+    m_sz -= 128 * l;
   }
   memcpy(mp, m, m_sz);
   sha->i = m_sz;
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === FIPS 180-4 SHA2-512 / x86-64 AVX-512 8-lane multi-buffer compression */
+
+#include "plat_local.h"
+#include "sha2_api.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <immintrin.h>
+
+#define SHA2_512_AVX512 __attribute__((target("avx2,avx512f,avx512vl")))
+
+/* vector helpers: each 64-bit lane belongs to a different message */
+
+#define V8_ADD(x, y) _mm512_add_epi64(x, y)
+#define V8_ROR(x, n) _mm512_ror_epi64(x, n)
+#define V8_XOR3(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0x96)
+#define V8_CH(e, f, g) _mm512_ternarylogic_epi64(e, f, g, 0xCA)
+#define V8_MAJ(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xE8)
+
+/* processing step, sets "d" and "h" as a function of all 8 inputs */
+/* and message schedule "mi", round constant "ki" */
+#define STEP_SHA512_R8(a, b, c, d, e, f, g, h, mi, ki)                    \
+  {                                                                       \
+    h = V8_ADD(V8_ADD(h, V8_CH(e, f, g)),                                 \
+               V8_ADD(V8_ADD(mi, _mm512_set1_epi64(ki)),                  \
+                      V8_XOR3(V8_ROR(e, 14), V8_ROR(e, 18),               \
+                              V8_ROR(e, 41))));                           \
+    d = V8_ADD(d, h);                                                     \
+    h = V8_ADD(h, V8_ADD(V8_MAJ(a, b, c),                                 \
+                         V8_XOR3(V8_ROR(a, 28), V8_ROR(a, 34),            \
+                                 V8_ROR(a, 39))));                        \
+  }
+
+/* keying step, sets x0 as a function of 4 inputs */
+#define STEP_SHA512_K8(x0, x1, x9, xe)                                    \
+  {                                                                       \
+    x0 = V8_ADD(V8_ADD(x0, x9),                                           \
+                V8_ADD(V8_XOR3(V8_ROR(x1, 1), V8_ROR(x1, 8),              \
+                               _mm512_srli_epi64(x1, 7)),                 \
+                       V8_XOR3(V8_ROR(xe, 19), V8_ROR(xe, 61),            \
+                               _mm512_srli_epi64(xe, 6))));               \
+  }
+
+/* 4x4 transpose of 64-bit words; rows become columns */
+
+SHA2_512_AVX512
+static void sha2_512_tr4x4(__m256i r[4])
+{
+  __m256i t0, t1, t2, t3;
+
+  t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+  t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+  t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+  t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+
+  r[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+  r[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+  r[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+  r[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+/* gather four big-endian words at offset "off" from all 8 buffers; */
+/* z[j] has word j of buffer i in 64-bit lane i */
+
+SHA2_512_AVX512
+static void sha2_512_ld8(__m512i z[4], void *v[8], size_t off)
+{
+  const __m256i bswap = _mm256_set_epi8(
+      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+      13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  __m256i lo[4], hi[4];
+  int i;
+
+  for (i = 0; i < 4; i++)
+  {
+    lo[i] = _mm256_shuffle_epi8(
+        _mm256_loadu_si256((const __m256i *)((uint8_t *)v[i] + off)), bswap);
+    hi[i] = _mm256_shuffle_epi8(
+        _mm256_loadu_si256((const __m256i *)((uint8_t *)v[i + 4] + off)),
+        bswap);
+  }
+  sha2_512_tr4x4(lo);
+  sha2_512_tr4x4(hi);
+  for (i = 0; i < 4; i++)
+  {
+    z[i] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1);
+  }
+}
+
+/* inverse of sha2_512_ld8() */
+
+SHA2_512_AVX512
+static void sha2_512_st8(void *v[8], size_t off, const __m512i z[4])
+{
+  const __m256i bswap = _mm256_set_epi8(
+      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+      13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  __m256i lo[4], hi[4];
+  int i;
+
+  for (i = 0; i < 4; i++)
+  {
+    lo[i] = _mm512_castsi512_si256(z[i]);
+    hi[i] = _mm512_extracti64x4_epi64(z[i], 1);
+  }
+  sha2_512_tr4x4(lo);
+  sha2_512_tr4x4(hi);
+  for (i = 0; i < 4; i++)
+  {
+    _mm256_storeu_si256((__m256i *)((uint8_t *)v[i] + off),
+                        _mm256_shuffle_epi8(lo[i], bswap));
+    _mm256_storeu_si256((__m256i *)((uint8_t *)v[i + 4] + off),
+                        _mm256_shuffle_epi8(hi[i], bswap));
+  }
+}
+
+/* eight independent compression functions; v[i] as in sha2_512_compress() */
+
+SHA2_512_AVX512
+void sha2_512_compress_x8_avx512(void *v[8])
+{
+  const uint64_t *kp = sha2_512_k;
+  __m512i s[8], m[16];
+  __m512i a, b, c, d, e, f, g, h;
+  __m512i m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, ma, mb, mc, md, me, mf;
+  int i;
+
+  /* get state and message, one message per 64-bit lane */
+  for (i = 0; i < 2; i++)
+  {
+    sha2_512_ld8(s + 4 * i, v, 32 * i);
+  }
+  for (i = 0; i < 4; i++)
+  {
+    sha2_512_ld8(m + 4 * i, v, 64 + 32 * i);
+  }
+
+  a = s[0];
+  b = s[1];
+  c = s[2];
+  d = s[3];
+  e = s[4];
+  f = s[5];
+  g = s[6];
+  h = s[7];
+
+  m0 = m[0];
+  m1 = m[1];
+  m2 = m[2];
+  m3 = m[3];
+  m4 = m[4];
+  m5 = m[5];
+  m6 = m[6];
+  m7 = m[7];
+  m8 = m[8];
+  m9 = m[9];
+  ma = m[10];
+  mb = m[11];
+  mc = m[12];
+  md = m[13];
+  me = m[14];
+  mf = m[15];
+
+  while (1)
+  {
+    /* main rounds */
+    STEP_SHA512_R8(a, b, c, d, e, f, g, h, m0, kp[0]);
+    STEP_SHA512_R8(h, a, b, c, d, e, f, g, m1, kp[1]);
+    STEP_SHA512_R8(g, h, a, b, c, d, e, f, m2, kp[2]);
+    STEP_SHA512_R8(f, g, h, a, b, c, d, e, m3, kp[3]);
+    STEP_SHA512_R8(e, f, g, h, a, b, c, d, m4, kp[4]);
+    STEP_SHA512_R8(d, e, f, g, h, a, b, c, m5, kp[5]);
+    STEP_SHA512_R8(c, d, e, f, g, h, a, b, m6, kp[6]);
+    STEP_SHA512_R8(b, c, d, e, f, g, h, a, m7, kp[7]);
+    STEP_SHA512_R8(a, b, c, d, e, f, g, h, m8, kp[8]);
+    STEP_SHA512_R8(h, a, b, c, d, e, f, g, m9, kp[9]);
+    STEP_SHA512_R8(g, h, a, b, c, d, e, f, ma, kp[10]);
+    STEP_SHA512_R8(f, g, h, a, b, c, d, e, mb, kp[11]);
+    STEP_SHA512_R8(e, f, g, h, a, b, c, d, mc, kp[12]);
+    STEP_SHA512_R8(d, e, f, g, h, a, b, c, md, kp[13]);
+    STEP_SHA512_R8(c, d, e, f, g, h, a, b, me, kp[14]);
+    STEP_SHA512_R8(b, c, d, e, f, g, h, a, mf, kp[15]);
+
+    if (kp == &sha2_512_k[80 - 16])
+    {
+      break;
+    }
+    kp += 16;
+
+    STEP_SHA512_K8(m0, m1, m9, me); /* key schedule */
+    STEP_SHA512_K8(m1, m2, ma, mf);
+    STEP_SHA512_K8(m2, m3, mb, m0);
+    STEP_SHA512_K8(m3, m4, mc, m1);
+    STEP_SHA512_K8(m4, m5, md, m2);
+    STEP_SHA512_K8(m5, m6, me, m3);
+    STEP_SHA512_K8(m6, m7, mf, m4);
+    STEP_SHA512_K8(m7, m8, m0, m5);
+    STEP_SHA512_K8(m8, m9, m1, m6);
+    STEP_SHA512_K8(m9, ma, m2, m7);
+    STEP_SHA512_K8(ma, mb, m3, m8);
+    STEP_SHA512_K8(mb, mc, m4, m9);
+    STEP_SHA512_K8(mc, md, m5, ma);
+    STEP_SHA512_K8(md, me, m6, mb);
+    STEP_SHA512_K8(me, mf, m7, mc);
+    STEP_SHA512_K8(mf, m0, m8, md);
+  }
+
+  s[0] = V8_ADD(s[0], a);
+  s[1] = V8_ADD(s[1], b);
+  s[2] = V8_ADD(s[2], c);
+  s[3] = V8_ADD(s[3], d);
+  s[4] = V8_ADD(s[4], e);
+  s[5] = V8_ADD(s[5], f);
+  s[6] = V8_ADD(s[6], g);
+  s[7] = V8_ADD(s[7], h);
+
+  for (i = 0; i < 2; i++)
+  {
+    sha2_512_st8(v, 32 * i, s + 4 * i);
+  }
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(sha2_512_avx512)
+
+#endif /* PLAT_X64_SIMD */
@@ -16,6 +16,7 @@ extern "C"
 #include <stddef.h>
 #include <stdint.h>
 #include "cbmc.h"
+#include "plat_local.h"
 
   /* === Single-call hash wrappers === */
 
@@ -91,10 +92,55 @@ extern "C"
   void sha2_256_copy(sha2_256_t *dst, const sha2_256_t *src);
   void sha2_512_copy(sha2_512_t *dst, const sha2_512_t *src);
 
-  /* compression functions */
+  /* compression functions; "v" holds the state followed by one block */
   void sha2_256_compress(void *v);
   void sha2_512_compress(void *v);
 
+  /* compress "nblk" consecutive blocks from "m" into the state "s" */
+  void sha2_256_compress_blocks(void *s, const uint8_t *m, size_t nblk);
+  void sha2_512_compress_blocks(void *s, const uint8_t *m, size_t nblk);
+
+  /* hash chain: "nstep" >= 1 compressions of block "m" from state "iv"; */
+  /* each digest's first "n" bytes are fed back into "m" at "off" and the */
+  /* big-endian 32-bit counter at "off" - 4 is incremented. Needs */
+  /* "off" >= 20 (block bytes 0..15 fixed). Last "n" bytes go to "y". */
+  void sha2_256_chain_blocks(uint8_t *y, const void *iv, uint8_t *m,
+                             size_t off, size_t n, size_t nstep);
+
+  /* multi-buffer: sha2_256_compress(v[i]) for each lane i in the bit */
+  /* mask "act", independently. All v[i] must point to buffers; lanes */
+  /* outside "act" are don't-care, and only "act" lanes are counted. */
+  void sha2_256_compress_x8(void *v[8], uint32_t act);
+  void sha2_256_compress_x16(void *v[16], uint32_t act);
+  void sha2_512_compress_x4(void *v[4], uint32_t act);
+  void sha2_512_compress_x8(void *v[8], uint32_t act);
+
+  /* lanes worth filling per sha2_256_compress_x16() call; 16, 8, or 1 */
+  /* if sequential sha2_256_compress() calls are as fast */
+  size_t sha2_256_lanes(void);
+
+  /* lanes worth filling per sha2_512_compress_x8() call; 8, 4, or 1 */
+  size_t sha2_512_lanes(void);
+
+  /* 4.2.2 SHA-224 and SHA-256 Constants */
+  extern const uint32_t sha2_256_k[64];
+
+  /* 4.2.3 SHA-384, SHA-512, SHA-512/224 and SHA-512/256 Constants */
+  extern const uint64_t sha2_512_k[80];
+
+#ifdef PLAT_X64_SIMD
+  /* x86-64 kernels: call only if plat_x64_features() has the extension. */
+  void sha2_256_compress_blocks_shani(void *s, const uint8_t *m,
+                                      size_t nblk); /* PLAT_X64_SHA */
+  void sha2_256_chain_blocks_shani(uint8_t *y, const void *iv, uint8_t *m,
+                                   size_t off, size_t n,
+                                   size_t nstep); /* PLAT_X64_SHA */
+  void sha2_256_compress_x8_avx2(void *v[8]);     /* PLAT_X64_AVX2 */
+  void sha2_256_compress_x16_avx512(void *v[16]); /* PLAT_X64_AVX512 */
+  void sha2_512_compress_x4_avx2(void *v[4]);     /* PLAT_X64_AVX2 */
+  void sha2_512_compress_x8_avx512(void *v[8]);   /* PLAT_X64_AVX512 */
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,7 +9,77 @@
 #include "sha3_api.h"
 #include "cbmc.h"
 
-/* These functions have not been optimized for performance. */
+/* Input and output move a 64-bit lane at a time once the position is */
+/* lane-aligned; only the unaligned head and tail bytes go byte-wise. */
+/* sha3_xorl / sha3_getl work on lane i, sha3_xorb / sha3_getb on byte j. */
+
+#if PLAT_XLEN == 32
+
+/* 32-bit targets keep the state bit-interleaved for keccak_f1600_bi32(); */
+/* input and output are converted as they are absorbed and squeezed */
+
+static void sha3_xorl(sha3_var_t *c, size_t i, uint64_t v)
+{
+  uint32_t lo = unzip32((uint32_t)v);
+  uint32_t hi = unzip32((uint32_t)(v >> 32));
+
+  c->st.w[2 * i] ^= (lo & 0x0000FFFF) | (hi << 16);
+  c->st.w[2 * i + 1] ^= (lo >> 16) | (hi & 0xFFFF0000);
+}
+
+static uint64_t sha3_getl(const sha3_var_t *c, size_t i)
+{
+  uint32_t ev = c->st.w[2 * i];
+  uint32_t od = c->st.w[2 * i + 1];
+  uint32_t lo = zip32((ev & 0x0000FFFF) | (od << 16));
+  uint32_t hi = zip32((ev >> 16) | (od & 0xFFFF0000));
+
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void sha3_xorb(sha3_var_t *c, size_t j, uint8_t v)
+{
+  uint32_t t = unzip32((uint32_t)v << (8 * (j & 3)));
+  size_t s = (j & 4) << 2;
+
+  c->st.w[2 * (j >> 3)] ^= (t & 0x0000FFFF) << s;
+  c->st.w[2 * (j >> 3) + 1] ^= (t >> 16) << s;
+}
+
+static uint8_t sha3_getb(const sha3_var_t *c, size_t j)
+{
+  size_t s = (j & 4) << 2;
+  uint32_t t = ((c->st.w[2 * (j >> 3)] >> s) & 0x0000FFFF) |
+               (((c->st.w[2 * (j >> 3) + 1] >> s) & 0x0000FFFF) << 16);
+
+  return (uint8_t)(zip32(t) >> (8 * (j & 3)));
+}
+
+static void sha3_permute(sha3_var_t *c) { keccak_f1600_bi32(c->st.w); }
+
+#else
+
+static void sha3_xorl(sha3_var_t *c, size_t i, uint64_t v)
+{
+  c->st.d[i] ^= v;
+}
+
+static uint64_t sha3_getl(const sha3_var_t *c, size_t i) { return c->st.d[i]; }
+
+static void sha3_xorb(sha3_var_t *c, size_t j, uint8_t v)
+{
+  c->st.d[j >> 3] ^= ((uint64_t)v) << (8 * (j & 7));
+}
+
+static uint8_t sha3_getb(const sha3_var_t *c, size_t j)
+{
+  return (uint8_t)(c->st.d[j >> 3] >> (8 * (j & 7)));
+}
+
+static void sha3_permute(sha3_var_t *c) { keccak_f1600(c->st.d); }
+
+#endif
+
 /* initialize the context for SHA3 */
 
 void sha3_init(sha3_var_t *c, size_t md_sz)
@@ -25,18 +95,44 @@ void sha3_init(sha3_var_t *c, size_t md_sz)
 
 void sha3_update(sha3_var_t *c, const void *data, size_t len)
 {
-  size_t i, j;
+  const uint8_t *p = (const uint8_t *)data;
+  size_t j, r;
 
   j = c->pt;
-  for (i = 0; i < len; i++)
+  r = c->r_sz; /* always a multiple of 8 */
+
+  /* bytes up to a lane boundary */
+  while (len > 0 && (j & 7) != 0)
+  {
+    sha3_xorb(c, j++, *p++);
+    len--;
+    if (j >= r)
+    {
+      sha3_permute(c);
+      j = 0;
+    }
+  }
+
+  /* whole lanes */
+  while (len >= 8)
   {
-    c->st.b[j++] ^= ((const uint8_t *)data)[i];
-    if (j >= c->r_sz)
+    sha3_xorl(c, j >> 3, get64u_le(p));
+    p += 8;
+    len -= 8;
+    j += 8;
+    if (j >= r)
     {
-      keccak_f1600(c->st.d);
+      sha3_permute(c);
       j = 0;
     }
   }
+
+  /* remaining bytes; cannot fill the block */
+  while (len > 0)
+  {
+    sha3_xorb(c, j++, *p++);
+    len--;
+  }
   c->pt = j;
 }
 
@@ -46,13 +142,17 @@ void sha3_final(sha3_var_t *c, uint8_t *md)
 {
   size_t i;
 
-  c->st.b[c->pt] ^= 0x06;
-  c->st.b[c->r_sz - 1] ^= 0x80;
-  keccak_f1600(c->st.d);
+  sha3_xorb(c, c->pt, 0x06);
+  sha3_xorb(c, c->r_sz - 1, 0x80);
+  sha3_permute(c);
 
-  for (i = 0; i < c->md_sz; i++)
+  for (i = 0; i + 8 <= c->md_sz; i += 8)
+  {
+    put64u_le(md + i, sha3_getl(c, i >> 3));
+  }
+  for (; i < c->md_sz; i++)
   {
-    md[i] = c->st.b[i];
+    md[i] = sha3_getb(c, i);
   }
 }
 
@@ -72,27 +172,52 @@ void sha3(uint8_t *md, size_t md_sz, const void *in, size_t in_sz)
 
 void shake_out(sha3_var_t *c, uint8_t *out, size_t out_sz)
 {
-  size_t i, j;
+  size_t j, r;
 
   /* add padding on the first call */
   if (c->md_sz != 0)
   {
-    c->st.b[c->pt] ^= 0x1F;
-    c->st.b[c->r_sz - 1] ^= 0x80;
-    keccak_f1600(c->st.d);
+    sha3_xorb(c, c->pt, 0x1F);
+    sha3_xorb(c, c->r_sz - 1, 0x80);
+    sha3_permute(c);
     c->pt = 0;
     c->md_sz = 0;
   }
 
   j = c->pt;
-  for (i = 0; i < out_sz; i++)
+  r = c->r_sz;
+
+  /* bytes up to a lane boundary */
+  while (out_sz > 0 && (j & 7) != 0)
+  {
+    *out++ = sha3_getb(c, j++);
+    out_sz--;
+  }
+
+  /* whole lanes */
+  while (out_sz >= 8)
+  {
+    if (j >= r)
+    {
+      sha3_permute(c);
+      j = 0;
+    }
+    put64u_le(out, sha3_getl(c, j >> 3));
+    out += 8;
+    out_sz -= 8;
+    j += 8;
+  }
+
+  /* remaining bytes */
+  while (out_sz > 0)
   {
-    if (j >= c->r_sz)
+    if (j >= r)
     {
-      keccak_f1600(c->st.d);
+      sha3_permute(c);
       j = 0;
     }
-    out[i] = c->st.b[j++];
+    *out++ = sha3_getb(c, j++);
+    out_sz--;
   }
   c->pt = j;
 }
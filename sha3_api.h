@@ -16,6 +16,7 @@ extern "C"
 #include <stddef.h>
 #include <stdint.h>
 #include "cbmc.h"
+#include "plat_local.h"
 
   typedef struct
   { /* state context */
@@ -23,6 +24,7 @@ extern "C"
     {
       uint8_t b[200]; /* 8-bit bytes */
       uint64_t d[25]; /* 64-bit words */
+      uint32_t w[50]; /* bit-interleaved 32-bit words (PLAT_XLEN == 32) */
     } st;
     size_t pt, r_sz, md_sz;
   } sha3_var_t;
@@ -59,6 +61,35 @@ extern "C"
   /* core permutation */
   void keccak_f1600(uint64_t x[25]);
 
+  /* four permutations; lane i of state j is in x[4 * i + j]. States */
+  /* outside the bit mask "act" are don't-care and not counted. */
+  void keccak_f1600_x4(uint64_t x[4 * 25], uint32_t act);
+
+  /* eight permutations; lane i of state j is in x[8 * i + j] */
+  void keccak_f1600_x8(uint64_t x[8 * 25], uint32_t act);
+
+  /* states worth filling per multi-lane call; 8 (keccak_f1600_x8), */
+  /* 4 (keccak_f1600_x4), or 1 if keccak_f1600() is as fast */
+  size_t keccak_f1600_lanes(void);
+
+#if PLAT_XLEN == 32
+  /* bit-interleaved state: lane i is in x[2 * i] (even bits) and */
+  /* x[2 * i + 1] (odd bits); keccak_bi32_in/out convert to and from lanes */
+  void keccak_f1600_bi32(uint32_t x[50]);
+  void keccak_bi32_in(uint32_t w[50], const uint64_t x[25]);
+  void keccak_bi32_out(uint64_t x[25], const uint32_t w[50]);
+#endif
+
+  /* 3.2.5 Algorithm 6: iota step round constants */
+  extern const uint64_t keccak_rc[24];
+
+#ifdef PLAT_X64_SIMD
+  /* x86-64 kernels: call only if plat_x64_features() has the extension. */
+  void keccak_f1600_avx512(uint64_t x[25]);        /* PLAT_X64_AVX512 */
+  void keccak_f1600_x4_avx2(uint64_t x[4 * 25]);   /* PLAT_X64_AVX2 */
+  void keccak_f1600_x8_avx512(uint64_t x[8 * 25]); /* PLAT_X64_AVX512 */
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,7 @@
  * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
  */
 
-/* === FIPS 202 Keccak permutation implementation for a 64-bit target. */
+/* === FIPS 202 Keccak permutation implementation for 64- and 32-bit targets. */
 
 #include "plat_local.h"
 #include "sha3_api.h"
@@ -12,144 +12,620 @@
 uint64_t keccak_f1600_count = 0; /* instrumentation */
 #endif
 
-/* forward permutation */
+/* round constants */
+
+const uint64_t keccak_rc[24] = {
+    UINT64_C(0x0000000000000001), UINT64_C(0x0000000000008082),
+    UINT64_C(0x800000000000808A), UINT64_C(0x8000000080008000),
+    UINT64_C(0x000000000000808B), UINT64_C(0x0000000080000001),
+    UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008009),
+    UINT64_C(0x000000000000008A), UINT64_C(0x0000000000000088),
+    UINT64_C(0x0000000080008009), UINT64_C(0x000000008000000A),
+    UINT64_C(0x000000008000808B), UINT64_C(0x800000000000008B),
+    UINT64_C(0x8000000000008089), UINT64_C(0x8000000000008003),
+    UINT64_C(0x8000000000008002), UINT64_C(0x8000000000000080),
+    UINT64_C(0x000000000000800A), UINT64_C(0x800000008000000A),
+    UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008080),
+    UINT64_C(0x0000000080000001), UINT64_C(0x8000000080008008)};
+
+#if PLAT_XLEN == 32
+
+/* On 32-bit targets the permutation works on a bit-interleaved state: */
+/* lane i is split into x[2 * i] (even bits) and x[2 * i + 1] (odd bits), */
+/* so each 64-bit rotation becomes two 32-bit rotations. */
+
+/* round constants, bit-interleaved */
+
+static const uint32_t keccak_rc_bi32[48] = {
+    0x00000001, 0x00000000, 0x00000000, 0x00000089, 0x00000000, 0x8000008B,
+    0x00000000, 0x80008080, 0x00000001, 0x0000008B, 0x00000001, 0x00008000,
+    0x00000001, 0x80008088, 0x00000001, 0x80000082, 0x00000000, 0x0000000B,
+    0x00000000, 0x0000000A, 0x00000001, 0x00008082, 0x00000000, 0x00008003,
+    0x00000001, 0x0000808B, 0x00000001, 0x8000000B, 0x00000001, 0x8000008A,
+    0x00000001, 0x80000081, 0x00000000, 0x80000081, 0x00000000, 0x80000008,
+    0x00000000, 0x00000083, 0x00000000, 0x80008003, 0x00000001, 0x80008088,
+    0x00000000, 0x80000088, 0x00000001, 0x00008000, 0x00000000, 0x80008082};
+
+/* one round from state "a" to state "e", lane complementing as below */
+
+#define KECCAK_ROUND_BI32(a, e, rc)            \
+  {                                            \
+    /* Theta */                                \
+    c0 = a##0 ^ a##10 ^ a##20 ^ a##30 ^ a##40; \
+    c1 = a##1 ^ a##11 ^ a##21 ^ a##31 ^ a##41; \
+    c2 = a##2 ^ a##12 ^ a##22 ^ a##32 ^ a##42; \
+    c3 = a##3 ^ a##13 ^ a##23 ^ a##33 ^ a##43; \
+    c4 = a##4 ^ a##14 ^ a##24 ^ a##34 ^ a##44; \
+    c5 = a##5 ^ a##15 ^ a##25 ^ a##35 ^ a##45; \
+    c6 = a##6 ^ a##16 ^ a##26 ^ a##36 ^ a##46; \
+    c7 = a##7 ^ a##17 ^ a##27 ^ a##37 ^ a##47; \
+    c8 = a##8 ^ a##18 ^ a##28 ^ a##38 ^ a##48; \
+    c9 = a##9 ^ a##19 ^ a##29 ^ a##39 ^ a##49; \
+    d0 = c8 ^ rol32(c3, 1);                    \
+    d1 = c9 ^ c2;                              \
+    d2 = c0 ^ rol32(c5, 1);                    \
+    d3 = c1 ^ c4;                              \
+    d4 = c2 ^ rol32(c7, 1);                    \
+    d5 = c3 ^ c6;                              \
+    d6 = c4 ^ rol32(c9, 1);                    \
+    d7 = c5 ^ c8;                              \
+    d8 = c6 ^ rol32(c1, 1);                    \
+    d9 = c7 ^ c0;                              \
+    /* Rho Pi Chi, output plane 0 */           \
+    b0 = a##0 ^ d0;                            \
+    b1 = a##1 ^ d1;                            \
+    b2 = rol32(a##12 ^ d2, 22);                \
+    b3 = rol32(a##13 ^ d3, 22);                \
+    b4 = rol32(a##25 ^ d5, 22);                \
+    b5 = rol32(a##24 ^ d4, 21);                \
+    b6 = rol32(a##37 ^ d7, 11);                \
+    b7 = rol32(a##36 ^ d6, 10);                \
+    b8 = rol32(a##48 ^ d8, 7);                 \
+    b9 = rol32(a##49 ^ d9, 7);                 \
+    e##0 = b0 ^ (b2 | b4);                     \
+    e##2 = b2 ^ (~b4 | b6);                    \
+    e##4 = b4 ^ (b6 & b8);                     \
+    e##6 = b6 ^ (b8 | b0);                     \
+    e##8 = b8 ^ (b0 & b2);                     \
+    e##1 = b1 ^ (b3 | b5);                     \
+    e##3 = b3 ^ (~b5 | b7);                    \
+    e##5 = b5 ^ (b7 & b9);                     \
+    e##7 = b7 ^ (b9 | b1);                     \
+    e##9 = b9 ^ (b1 & b3);                     \
+    /* Rho Pi Chi, output plane 1 */           \
+    b0 = rol32(a##6 ^ d6, 14);                 \
+    b1 = rol32(a##7 ^ d7, 14);                 \
+    b2 = rol32(a##18 ^ d8, 10);                \
+    b3 = rol32(a##19 ^ d9, 10);                \
+    b4 = rol32(a##21 ^ d1, 2);                 \
+    b5 = rol32(a##20 ^ d0, 1);                 \
+    b6 = rol32(a##33 ^ d3, 23);                \
+    b7 = rol32(a##32 ^ d2, 22);                \
+    b8 = rol32(a##45 ^ d5, 31);                \
+    b9 = rol32(a##44 ^ d4, 30);                \
+    e##10 = b0 ^ (b2 | b4);                    \
+    e##12 = b2 ^ (b4 & b6);                    \
+    e##14 = b4 ^ (b6 | ~b8);                   \
+    e##16 = b6 ^ (b8 | b0);                    \
+    e##18 = b8 ^ (b0 & b2);                    \
+    e##11 = b1 ^ (b3 | b5);                    \
+    e##13 = b3 ^ (b5 & b7);                    \
+    e##15 = b5 ^ (b7 | ~b9);                   \
+    e##17 = b7 ^ (b9 | b1);                    \
+    e##19 = b9 ^ (b1 & b3);                    \
+    /* Rho Pi Chi, output plane 2 */           \
+    b0 = rol32(a##3 ^ d3, 1);                  \
+    b1 = a##2 ^ d2;                            \
+    b2 = rol32(a##14 ^ d4, 3);                 \
+    b3 = rol32(a##15 ^ d5, 3);                 \
+    b4 = rol32(a##27 ^ d7, 13);                \
+    b5 = rol32(a##26 ^ d6, 12);                \
+    b6 = rol32(a##38 ^ d8, 4);                 \
+    b7 = rol32(a##39 ^ d9, 4);                 \
+    b8 = rol32(a##40 ^ d0, 9);                 \
+    b9 = rol32(a##41 ^ d1, 9);                 \
+    e##20 = b0 ^ (b2 | b4);                    \
+    e##22 = b2 ^ (b4 & b6);                    \
+    e##24 = b4 ^ (~b6 & b8);                   \
+    e##26 = ~b6 ^ (b8 | b0);                   \
+    e##28 = b8 ^ (b0 & b2);                    \
+    e##21 = b1 ^ (b3 | b5);                    \
+    e##23 = b3 ^ (b5 & b7);                    \
+    e##25 = b5 ^ (~b7 & b9);                   \
+    e##27 = ~b7 ^ (b9 | b1);                   \
+    e##29 = b9 ^ (b1 & b3);                    \
+    /* Rho Pi Chi, output plane 3 */           \
+    b0 = rol32(a##9 ^ d9, 14);                 \
+    b1 = rol32(a##8 ^ d8, 13);                 \
+    b2 = rol32(a##10 ^ d0, 18);                \
+    b3 = rol32(a##11 ^ d1, 18);                \
+    b4 = rol32(a##22 ^ d2, 5);                 \
+    b5 = rol32(a##23 ^ d3, 5);                 \
+    b6 = rol32(a##35 ^ d5, 8);                 \
+    b7 = rol32(a##34 ^ d4, 7);                 \
+    b8 = rol32(a##46 ^ d6, 28);                \
+    b9 = rol32(a##47 ^ d7, 28);                \
+    e##30 = b0 ^ (b2 & b4);                    \
+    e##32 = b2 ^ (b4 | b6);                    \
+    e##34 = b4 ^ (~b6 | b8);                   \
+    e##36 = ~b6 ^ (b8 & b0);                   \
+    e##38 = b8 ^ (b0 | b2);                    \
+    e##31 = b1 ^ (b3 & b5);                    \
+    e##33 = b3 ^ (b5 | b7);                    \
+    e##35 = b5 ^ (~b7 | b9);                   \
+    e##37 = ~b7 ^ (b9 & b1);                   \
+    e##39 = b9 ^ (b1 | b3);                    \
+    /* Rho Pi Chi, output plane 4 */           \
+    b0 = rol32(a##4 ^ d4, 31);                 \
+    b1 = rol32(a##5 ^ d5, 31);                 \
+    b2 = rol32(a##17 ^ d7, 28);                \
+    b3 = rol32(a##16 ^ d6, 27);                \
+    b4 = rol32(a##29 ^ d9, 20);                \
+    b5 = rol32(a##28 ^ d8, 19);                \
+    b6 = rol32(a##31 ^ d1, 21);                \
+    b7 = rol32(a##30 ^ d0, 20);                \
+    b8 = rol32(a##42 ^ d2, 1);                 \
+    b9 = rol32(a##43 ^ d3, 1);                 \
+    e##40 = b0 ^ (~b2 & b4);                   \
+    e##42 = ~b2 ^ (b4 | b6);                   \
+    e##44 = b4 ^ (b6 & b8);                    \
+    e##46 = b6 ^ (b8 | b0);                    \
+    e##48 = b8 ^ (b0 & b2);                    \
+    e##41 = b1 ^ (~b3 & b5);                   \
+    e##43 = ~b3 ^ (b5 | b7);                   \
+    e##45 = b5 ^ (b7 & b9);                    \
+    e##47 = b7 ^ (b9 | b1);                    \
+    e##49 = b9 ^ (b1 & b3);                    \
+    /* Iota */                                 \
+    e##0 ^= (rc)[0];                           \
+    e##1 ^= (rc)[1];                           \
+  }
+
+/* forward permutation on a bit-interleaved state */
+
+void keccak_f1600_bi32(uint32_t x[50])
+{
+  uint32_t a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14;
+  uint32_t a15, a16, a17, a18, a19, a20, a21, a22, a23, a24, a25, a26, a27;
+  uint32_t a28, a29, a30, a31, a32, a33, a34, a35, a36, a37, a38, a39, a40;
+  uint32_t a41, a42, a43, a44, a45, a46, a47, a48, a49;
+  uint32_t e0, e1, e2, e3, e4, e5, e6, e7, e8, e9, e10, e11, e12, e13, e14;
+  uint32_t e15, e16, e17, e18, e19, e20, e21, e22, e23, e24, e25, e26, e27;
+  uint32_t e28, e29, e30, e31, e32, e33, e34, e35, e36, e37, e38, e39, e40;
+  uint32_t e41, e42, e43, e44, e45, e46, e47, e48, e49;
+  uint32_t b0, b1, b2, b3, b4, b5, b6, b7, b8, b9;
+  uint32_t c0, c1, c2, c3, c4, c5, c6, c7, c8, c9;
+  uint32_t d0, d1, d2, d3, d4, d5, d6, d7, d8, d9;
+  int i;
+
+#ifdef SLH_EXPERIMENTAL
+  keccak_f1600_count++; /* instrumentation */
+#endif
+
+  /* lanes 1, 2, 8, 12, 17, 20 are held complemented */
+
+  a0 = x[0];
+  a1 = x[1];
+  a2 = ~x[2];
+  a3 = ~x[3];
+  a4 = ~x[4];
+  a5 = ~x[5];
+  a6 = x[6];
+  a7 = x[7];
+  a8 = x[8];
+  a9 = x[9];
+  a10 = x[10];
+  a11 = x[11];
+  a12 = x[12];
+  a13 = x[13];
+  a14 = x[14];
+  a15 = x[15];
+  a16 = ~x[16];
+  a17 = ~x[17];
+  a18 = x[18];
+  a19 = x[19];
+  a20 = x[20];
+  a21 = x[21];
+  a22 = x[22];
+  a23 = x[23];
+  a24 = ~x[24];
+  a25 = ~x[25];
+  a26 = x[26];
+  a27 = x[27];
+  a28 = x[28];
+  a29 = x[29];
+  a30 = x[30];
+  a31 = x[31];
+  a32 = x[32];
+  a33 = x[33];
+  a34 = ~x[34];
+  a35 = ~x[35];
+  a36 = x[36];
+  a37 = x[37];
+  a38 = x[38];
+  a39 = x[39];
+  a40 = ~x[40];
+  a41 = ~x[41];
+  a42 = x[42];
+  a43 = x[43];
+  a44 = x[44];
+  a45 = x[45];
+  a46 = x[46];
+  a47 = x[47];
+  a48 = x[48];
+  a49 = x[49];
+
+  /* two rounds per iteration */
+
+  for (i = 0; i < 48; i += 4)
+  {
+    KECCAK_ROUND_BI32(a, e, &keccak_rc_bi32[i]);
+    KECCAK_ROUND_BI32(e, a, &keccak_rc_bi32[i + 2]);
+  }
+
+  x[0] = a0;
+  x[1] = a1;
+  x[2] = ~a2;
+  x[3] = ~a3;
+  x[4] = ~a4;
+  x[5] = ~a5;
+  x[6] = a6;
+  x[7] = a7;
+  x[8] = a8;
+  x[9] = a9;
+  x[10] = a10;
+  x[11] = a11;
+  x[12] = a12;
+  x[13] = a13;
+  x[14] = a14;
+  x[15] = a15;
+  x[16] = ~a16;
+  x[17] = ~a17;
+  x[18] = a18;
+  x[19] = a19;
+  x[20] = a20;
+  x[21] = a21;
+  x[22] = a22;
+  x[23] = a23;
+  x[24] = ~a24;
+  x[25] = ~a25;
+  x[26] = a26;
+  x[27] = a27;
+  x[28] = a28;
+  x[29] = a29;
+  x[30] = a30;
+  x[31] = a31;
+  x[32] = a32;
+  x[33] = a33;
+  x[34] = ~a34;
+  x[35] = ~a35;
+  x[36] = a36;
+  x[37] = a37;
+  x[38] = a38;
+  x[39] = a39;
+  x[40] = ~a40;
+  x[41] = ~a41;
+  x[42] = a42;
+  x[43] = a43;
+  x[44] = a44;
+  x[45] = a45;
+  x[46] = a46;
+  x[47] = a47;
+  x[48] = a48;
+  x[49] = a49;
+}
+
+/* convert 64-bit lanes to and from the bit-interleaved representation */
+
+void keccak_bi32_in(uint32_t w[50], const uint64_t x[25])
+{
+  int i;
+  uint32_t lo, hi;
+
+  for (i = 0; i < 25; i++)
+  {
+    lo = unzip32((uint32_t)x[i]);
+    hi = unzip32((uint32_t)(x[i] >> 32));
+    w[2 * i] = (lo & 0x0000FFFF) | (hi << 16);
+    w[2 * i + 1] = (lo >> 16) | (hi & 0xFFFF0000);
+  }
+}
+
+void keccak_bi32_out(uint64_t x[25], const uint32_t w[50])
+{
+  int i;
+  uint32_t lo, hi;
+
+  for (i = 0; i < 25; i++)
+  {
+    lo = zip32((w[2 * i] & 0x0000FFFF) | (w[2 * i + 1] << 16));
+    hi = zip32((w[2 * i] >> 16) | (w[2 * i + 1] & 0xFFFF0000));
+    x[i] = ((uint64_t)hi << 32) | lo;
+  }
+}
+
+/* forward permutation on 64-bit lanes */
 
 void keccak_f1600(uint64_t x[25])
 {
-  /* round constants */
-  static const uint64_t keccak_rc[24] = {
-      UINT64_C(0x0000000000000001), UINT64_C(0x0000000000008082),
-      UINT64_C(0x800000000000808A), UINT64_C(0x8000000080008000),
-      UINT64_C(0x000000000000808B), UINT64_C(0x0000000080000001),
-      UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008009),
-      UINT64_C(0x000000000000008A), UINT64_C(0x0000000000000088),
-      UINT64_C(0x0000000080008009), UINT64_C(0x000000008000000A),
-      UINT64_C(0x000000008000808B), UINT64_C(0x800000000000008B),
-      UINT64_C(0x8000000000008089), UINT64_C(0x8000000000008003),
-      UINT64_C(0x8000000000008002), UINT64_C(0x8000000000000080),
-      UINT64_C(0x000000000000800A), UINT64_C(0x800000008000000A),
-      UINT64_C(0x8000000080008081), UINT64_C(0x8000000000008080),
-      UINT64_C(0x0000000080000001), UINT64_C(0x8000000080008008)};
+  uint32_t w[50];
+
+  keccak_bi32_in(w, x);
+  keccak_f1600_bi32(w);
+  keccak_bi32_out(x, w);
+}
 
+#else /* PLAT_XLEN == 64 */
+
+/* one round from state "a" to state "e"; lanes 1, 2, 8, 12, 17, 20 are */
+/* held complemented, which lets chi use mostly AND / OR without NOT */
+
+#define KECCAK_ROUND(a, e, rc)                \
+  {                                           \
+    /* Theta */                               \
+    c0 = a##0 ^ a##5 ^ a##10 ^ a##15 ^ a##20; \
+    c1 = a##1 ^ a##6 ^ a##11 ^ a##16 ^ a##21; \
+    c2 = a##2 ^ a##7 ^ a##12 ^ a##17 ^ a##22; \
+    c3 = a##3 ^ a##8 ^ a##13 ^ a##18 ^ a##23; \
+    c4 = a##4 ^ a##9 ^ a##14 ^ a##19 ^ a##24; \
+    d0 = c4 ^ rol64(c1, 1);                   \
+    d1 = c0 ^ rol64(c2, 1);                   \
+    d2 = c1 ^ rol64(c3, 1);                   \
+    d3 = c2 ^ rol64(c4, 1);                   \
+    d4 = c3 ^ rol64(c0, 1);                   \
+    /* Rho Pi Chi, output plane 0 */          \
+    b0 = a##0 ^ d0;                           \
+    b1 = rol64(a##6 ^ d1, 44);                \
+    b2 = rol64(a##12 ^ d2, 43);               \
+    b3 = rol64(a##18 ^ d3, 21);               \
+    b4 = rol64(a##24 ^ d4, 14);               \
+    e##0 = b0 ^ (b1 | b2);                    \
+    e##1 = b1 ^ (~b2 | b3);                   \
+    e##2 = b2 ^ (b3 & b4);                    \
+    e##3 = b3 ^ (b4 | b0);                    \
+    e##4 = b4 ^ (b0 & b1);                    \
+    /* Rho Pi Chi, output plane 1 */          \
+    b0 = rol64(a##3 ^ d3, 28);                \
+    b1 = rol64(a##9 ^ d4, 20);                \
+    b2 = rol64(a##10 ^ d0, 3);                \
+    b3 = rol64(a##16 ^ d1, 45);               \
+    b4 = rol64(a##22 ^ d2, 61);               \
+    e##5 = b0 ^ (b1 | b2);                    \
+    e##6 = b1 ^ (b2 & b3);                    \
+    e##7 = b2 ^ (b3 | ~b4);                   \
+    e##8 = b3 ^ (b4 | b0);                    \
+    e##9 = b4 ^ (b0 & b1);                    \
+    /* Rho Pi Chi, output plane 2 */          \
+    b0 = rol64(a##1 ^ d1, 1);                 \
+    b1 = rol64(a##7 ^ d2, 6);                 \
+    b2 = rol64(a##13 ^ d3, 25);               \
+    b3 = rol64(a##19 ^ d4, 8);                \
+    b4 = rol64(a##20 ^ d0, 18);               \
+    e##10 = b0 ^ (b1 | b2);                   \
+    e##11 = b1 ^ (b2 & b3);                   \
+    e##12 = b2 ^ (~b3 & b4);                  \
+    e##13 = ~b3 ^ (b4 | b0);                  \
+    e##14 = b4 ^ (b0 & b1);                   \
+    /* Rho Pi Chi, output plane 3 */          \
+    b0 = rol64(a##4 ^ d4, 27);                \
+    b1 = rol64(a##5 ^ d0, 36);                \
+    b2 = rol64(a##11 ^ d1, 10);               \
+    b3 = rol64(a##17 ^ d2, 15);               \
+    b4 = rol64(a##23 ^ d3, 56);               \
+    e##15 = b0 ^ (b1 & b2);                   \
+    e##16 = b1 ^ (b2 | b3);                   \
+    e##17 = b2 ^ (~b3 | b4);                  \
+    e##18 = ~b3 ^ (b4 & b0);                  \
+    e##19 = b4 ^ (b0 | b1);                   \
+    /* Rho Pi Chi, output plane 4 */          \
+    b0 = rol64(a##2 ^ d2, 62);                \
+    b1 = rol64(a##8 ^ d3, 55);                \
+    b2 = rol64(a##14 ^ d4, 39);               \
+    b3 = rol64(a##15 ^ d0, 41);               \
+    b4 = rol64(a##21 ^ d1, 2);                \
+    e##20 = b0 ^ (~b1 & b2);                  \
+    e##21 = ~b1 ^ (b2 | b3);                  \
+    e##22 = b2 ^ (b3 & b4);                   \
+    e##23 = b3 ^ (b4 | b0);                   \
+    e##24 = b4 ^ (b0 & b1);                   \
+    /* Iota */                                \
+    e##0 ^= rc;                               \
+  }
+
+/* portable forward permutation */
+
+static void keccak_f1600_c(uint64_t x[25])
+{
+  uint64_t a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12;
+  uint64_t a13, a14, a15, a16, a17, a18, a19, a20, a21, a22, a23, a24;
+  uint64_t e0, e1, e2, e3, e4, e5, e6, e7, e8, e9, e10, e11, e12;
+  uint64_t e13, e14, e15, e16, e17, e18, e19, e20, e21, e22, e23, e24;
+  uint64_t b0, b1, b2, b3, b4, c0, c1, c2, c3, c4, d0, d1, d2, d3, d4;
   int i;
-  uint64_t t, y0, y1, y2, y3, y4;
 
+  a0 = x[0];
+  a1 = ~x[1];
+  a2 = ~x[2];
+  a3 = x[3];
+  a4 = x[4];
+  a5 = x[5];
+  a6 = x[6];
+  a7 = x[7];
+  a8 = ~x[8];
+  a9 = x[9];
+  a10 = x[10];
+  a11 = x[11];
+  a12 = ~x[12];
+  a13 = x[13];
+  a14 = x[14];
+  a15 = x[15];
+  a16 = x[16];
+  a17 = ~x[17];
+  a18 = x[18];
+  a19 = x[19];
+  a20 = ~x[20];
+  a21 = x[21];
+  a22 = x[22];
+  a23 = x[23];
+  a24 = x[24];
+
+  /* two rounds per iteration */
+
+  for (i = 0; i < 24; i += 2)
+  {
+    KECCAK_ROUND(a, e, keccak_rc[i]);
+    KECCAK_ROUND(e, a, keccak_rc[i + 1]);
+  }
+
+  x[0] = a0;
+  x[1] = ~a1;
+  x[2] = ~a2;
+  x[3] = a3;
+  x[4] = a4;
+  x[5] = a5;
+  x[6] = a6;
+  x[7] = a7;
+  x[8] = ~a8;
+  x[9] = a9;
+  x[10] = a10;
+  x[11] = a11;
+  x[12] = ~a12;
+  x[13] = a13;
+  x[14] = a14;
+  x[15] = a15;
+  x[16] = a16;
+  x[17] = ~a17;
+  x[18] = a18;
+  x[19] = a19;
+  x[20] = ~a20;
+  x[21] = a21;
+  x[22] = a22;
+  x[23] = a23;
+  x[24] = a24;
+}
+
+/* forward permutation; selects a hardware implementation if available */
+
+void keccak_f1600(uint64_t x[25])
+{
 #ifdef SLH_EXPERIMENTAL
   keccak_f1600_count++; /* instrumentation */
 #endif
 
-  /* iteration */
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_AVX512)
+  {
+    keccak_f1600_avx512(x);
+    return;
+  }
+#endif
+
+  keccak_f1600_c(x);
+}
+
+#endif /* PLAT_XLEN */
+
+/* four permutations; lane i of state j is in x[4 * i + j]. Without */
+/* SIMD lanes, only the states in "act" are permuted */
+
+void keccak_f1600_x4(uint64_t x[4 * 25], uint32_t act)
+{
+  uint64_t y[25];
+  int i, j;
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_AVX2)
+  {
+#ifdef SLH_EXPERIMENTAL
+    for (j = 0; j < 4; j++)
+    {
+      keccak_f1600_count += (act >> j) & 1; /* instrumentation */
+    }
+#endif
+    keccak_f1600_x4_avx2(x);
+    return;
+  }
+#endif
+
+  for (j = 0; j < 4; j++)
+  {
+    if (((act >> j) & 1) == 0)
+    {
+      continue;
+    }
+    for (i = 0; i < 25; i++)
+    {
+      y[i] = x[4 * i + j];
+    }
+    keccak_f1600(y);
+    for (i = 0; i < 25; i++)
+    {
+      x[4 * i + j] = y[i];
+    }
+  }
+}
+
+/* eight permutations; lane i of state j is in x[8 * i + j] */
+
+void keccak_f1600_x8(uint64_t x[8 * 25], uint32_t act)
+{
+  uint64_t y[4 * 25];
+  int i, j, k;
+
+#ifdef PLAT_X64_SIMD
+  if (plat_x64_features() & PLAT_X64_AVX512)
+  {
+#ifdef SLH_EXPERIMENTAL
+    for (j = 0; j < 8; j++)
+    {
+      keccak_f1600_count += (act >> j) & 1; /* instrumentation */
+    }
+#endif
+    keccak_f1600_x8_avx512(x);
+    return;
+  }
+#endif
+
+  for (k = 0; k < 8; k += 4)
+  {
+    if (((act >> k) & 0xF) == 0)
+    {
+      continue;
+    }
+    for (i = 0; i < 25; i++)
+    {
+      for (j = 0; j < 4; j++)
+      {
+        y[4 * i + j] = x[8 * i + k + j];
+      }
+    }
+    keccak_f1600_x4(y, (act >> k) & 0xF);
+    for (i = 0; i < 25; i++)
+    {
+      for (j = 0; j < 4; j++)
+      {
+        x[8 * i + k + j] = y[4 * i + j];
+      }
+    }
+  }
+}
+
+/* number of permutations worth batching per call: 8 or 4 with the */
+/* SIMD kernels, or 1 if sequential keccak_f1600() calls are as fast */
+
+size_t keccak_f1600_lanes(void)
+{
+#ifdef PLAT_X64_SIMD
+  uint32_t f = plat_x64_features();
 
-  for (i = 0; i < 24; i++)
+  if (f & PLAT_X64_AVX512)
   {
-    /* Theta */
-
-    y4 = x[4] ^ x[9] ^ x[14] ^ x[19] ^ x[24];
-    y1 = x[1] ^ x[6] ^ x[11] ^ x[16] ^ x[21];
-    y3 = x[3] ^ x[8] ^ x[13] ^ x[18] ^ x[23];
-    y0 = x[0] ^ x[5] ^ x[10] ^ x[15] ^ x[20];
-    y2 = x[2] ^ x[7] ^ x[12] ^ x[17] ^ x[22];
-
-    t = ror64(y4, 63);
-    y4 ^= ror64(y1, 63);
-    y1 ^= ror64(y3, 63);
-    y3 ^= ror64(y0, 63);
-    y0 ^= ror64(y2, 63);
-    y2 ^= t;
-
-    x[0] ^= y4;
-    x[1] ^= y0;
-    x[2] ^= y1;
-    x[3] ^= y2;
-    x[4] ^= y3;
-    x[5] ^= y4;
-    x[6] ^= y0;
-    x[7] ^= y1;
-    x[8] ^= y2;
-    x[9] ^= y3;
-    x[10] ^= y4;
-    x[11] ^= y0;
-    x[12] ^= y1;
-    x[13] ^= y2;
-    x[14] ^= y3;
-    x[15] ^= y4;
-    x[16] ^= y0;
-    x[17] ^= y1;
-    x[18] ^= y2;
-    x[19] ^= y3;
-    x[20] ^= y4;
-    x[21] ^= y0;
-    x[22] ^= y1;
-    x[23] ^= y2;
-    x[24] ^= y3;
-
-    /* Rho Pi */
-
-    t = ror64(x[1], 63);
-    x[1] = ror64(x[6], 20);
-    x[6] = ror64(x[9], 44);
-    x[9] = ror64(x[22], 3);
-    x[22] = ror64(x[14], 25);
-    x[14] = ror64(x[20], 46);
-    x[20] = ror64(x[2], 2);
-    x[2] = ror64(x[12], 21);
-    x[12] = ror64(x[13], 39);
-    x[13] = ror64(x[19], 56);
-    x[19] = ror64(x[23], 8);
-    x[23] = ror64(x[15], 23);
-    x[15] = ror64(x[4], 37);
-    x[4] = ror64(x[24], 50);
-    x[24] = ror64(x[21], 62);
-    x[21] = ror64(x[8], 9);
-    x[8] = ror64(x[16], 19);
-    x[16] = ror64(x[5], 28);
-    x[5] = ror64(x[3], 36);
-    x[3] = ror64(x[18], 43);
-    x[18] = ror64(x[17], 49);
-    x[17] = ror64(x[11], 54);
-    x[11] = ror64(x[7], 58);
-    x[7] = ror64(x[10], 61);
-    x[10] = t;
-
-    /* Chi */
-
-    t = x[4] & ~x[3];
-    x[4] ^= x[1] & ~x[0];
-    x[1] ^= x[3] & ~x[2];
-    x[3] ^= x[0] & ~x[4];
-    x[0] ^= x[2] & ~x[1];
-    x[2] ^= t;
-
-    t = x[9] & ~x[8];
-    x[9] ^= x[6] & ~x[5];
-    x[6] ^= x[8] & ~x[7];
-    x[8] ^= x[5] & ~x[9];
-    x[5] ^= x[7] & ~x[6];
-    x[7] ^= t;
-
-    t = x[14] & ~x[13];
-    x[14] ^= x[11] & ~x[10];
-    x[11] ^= x[13] & ~x[12];
-    x[13] ^= x[10] & ~x[14];
-    x[10] ^= x[12] & ~x[11];
-    x[12] ^= t;
-
-    t = x[19] & ~x[18];
-    x[19] ^= x[16] & ~x[15];
-    x[16] ^= x[18] & ~x[17];
-    x[18] ^= x[15] & ~x[19];
-    x[15] ^= x[17] & ~x[16];
-    x[17] ^= t;
-
-    t = x[24] & ~x[23];
-    x[24] ^= x[21] & ~x[20];
-    x[21] ^= x[23] & ~x[22];
-    x[23] ^= x[20] & ~x[24];
-    x[20] ^= x[22] & ~x[21];
-    x[22] ^= t;
-
-    /* Iota */
-
-    x[0] = x[0] ^ keccak_rc[i];
+    return 8;
   }
+  if (f & PLAT_X64_AVX2)
+  {
+    return 4;
+  }
+#endif
+  return 1;
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === FIPS 202 Keccak permutation / x86-64 AVX2 4-way interleaved states */
+
+#include "plat_local.h"
+#include "sha3_api.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <immintrin.h>
+
+#define SHA3_F1600_AVX2 __attribute__((target("avx2")))
+
+/* vector helpers: each 64-bit lane belongs to a different state */
+
+#define V4_XOR(x, y) _mm256_xor_si256(x, y)
+#define V4_ANDN(x, y) _mm256_andnot_si256(x, y) /* ~x & y */
+#define V4_ROR(x, n) \
+  _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+
+/* chi on a row of five lanes */
+#define CHI_ROW4(x0, x1, x2, x3, x4)    \
+  {                                     \
+    t = V4_ANDN(x3, x4);                \
+    x4 = V4_XOR(x4, V4_ANDN(x0, x1));   \
+    x1 = V4_XOR(x1, V4_ANDN(x2, x3));   \
+    x3 = V4_XOR(x3, V4_ANDN(x4, x0));   \
+    x0 = V4_XOR(x0, V4_ANDN(x1, x2));   \
+    x2 = V4_XOR(x2, t);                 \
+  }
+
+/* four permutations; lane i of state j is in x[4 * i + j] */
+
+SHA3_F1600_AVX2
+void keccak_f1600_x4_avx2(uint64_t x[4 * 25])
+{
+  __m256i s[25];
+  __m256i t, y0, y1, y2, y3, y4;
+  int i;
+
+  for (i = 0; i < 25; i++)
+  {
+    s[i] = _mm256_loadu_si256((const __m256i *)&x[4 * i]);
+  }
+
+  for (i = 0; i < 24; i++)
+  {
+    /* Theta */
+
+    y4 = V4_XOR(V4_XOR(V4_XOR(s[4], s[9]), V4_XOR(s[14], s[19])), s[24]);
+    y1 = V4_XOR(V4_XOR(V4_XOR(s[1], s[6]), V4_XOR(s[11], s[16])), s[21]);
+    y3 = V4_XOR(V4_XOR(V4_XOR(s[3], s[8]), V4_XOR(s[13], s[18])), s[23]);
+    y0 = V4_XOR(V4_XOR(V4_XOR(s[0], s[5]), V4_XOR(s[10], s[15])), s[20]);
+    y2 = V4_XOR(V4_XOR(V4_XOR(s[2], s[7]), V4_XOR(s[12], s[17])), s[22]);
+
+    t = V4_ROR(y4, 63);
+    y4 = V4_XOR(y4, V4_ROR(y1, 63));
+    y1 = V4_XOR(y1, V4_ROR(y3, 63));
+    y3 = V4_XOR(y3, V4_ROR(y0, 63));
+    y0 = V4_XOR(y0, V4_ROR(y2, 63));
+    y2 = V4_XOR(y2, t);
+
+    s[0] = V4_XOR(s[0], y4);
+    s[1] = V4_XOR(s[1], y0);
+    s[2] = V4_XOR(s[2], y1);
+    s[3] = V4_XOR(s[3], y2);
+    s[4] = V4_XOR(s[4], y3);
+    s[5] = V4_XOR(s[5], y4);
+    s[6] = V4_XOR(s[6], y0);
+    s[7] = V4_XOR(s[7], y1);
+    s[8] = V4_XOR(s[8], y2);
+    s[9] = V4_XOR(s[9], y3);
+    s[10] = V4_XOR(s[10], y4);
+    s[11] = V4_XOR(s[11], y0);
+    s[12] = V4_XOR(s[12], y1);
+    s[13] = V4_XOR(s[13], y2);
+    s[14] = V4_XOR(s[14], y3);
+    s[15] = V4_XOR(s[15], y4);
+    s[16] = V4_XOR(s[16], y0);
+    s[17] = V4_XOR(s[17], y1);
+    s[18] = V4_XOR(s[18], y2);
+    s[19] = V4_XOR(s[19], y3);
+    s[20] = V4_XOR(s[20], y4);
+    s[21] = V4_XOR(s[21], y0);
+    s[22] = V4_XOR(s[22], y1);
+    s[23] = V4_XOR(s[23], y2);
+    s[24] = V4_XOR(s[24], y3);
+
+    /* Rho Pi */
+
+    t = V4_ROR(s[1], 63);
+    s[1] = V4_ROR(s[6], 20);
+    s[6] = V4_ROR(s[9], 44);
+    s[9] = V4_ROR(s[22], 3);
+    s[22] = V4_ROR(s[14], 25);
+    s[14] = V4_ROR(s[20], 46);
+    s[20] = V4_ROR(s[2], 2);
+    s[2] = V4_ROR(s[12], 21);
+    s[12] = V4_ROR(s[13], 39);
+    s[13] = V4_ROR(s[19], 56);
+    s[19] = V4_ROR(s[23], 8);
+    s[23] = V4_ROR(s[15], 23);
+    s[15] = V4_ROR(s[4], 37);
+    s[4] = V4_ROR(s[24], 50);
+    s[24] = V4_ROR(s[21], 62);
+    s[21] = V4_ROR(s[8], 9);
+    s[8] = V4_ROR(s[16], 19);
+    s[16] = V4_ROR(s[5], 28);
+    s[5] = V4_ROR(s[3], 36);
+    s[3] = V4_ROR(s[18], 43);
+    s[18] = V4_ROR(s[17], 49);
+    s[17] = V4_ROR(s[11], 54);
+    s[11] = V4_ROR(s[7], 58);
+    s[7] = V4_ROR(s[10], 61);
+    s[10] = t;
+
+    /* Chi */
+
+    CHI_ROW4(s[0], s[1], s[2], s[3], s[4]);
+    CHI_ROW4(s[5], s[6], s[7], s[8], s[9]);
+    CHI_ROW4(s[10], s[11], s[12], s[13], s[14]);
+    CHI_ROW4(s[15], s[16], s[17], s[18], s[19]);
+    CHI_ROW4(s[20], s[21], s[22], s[23], s[24]);
+
+    /* Iota */
+
+    s[0] = V4_XOR(s[0], _mm256_set1_epi64x(keccak_rc[i]));
+  }
+
+  for (i = 0; i < 25; i++)
+  {
+    _mm256_storeu_si256((__m256i *)&x[4 * i], s[i]);
+  }
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(sha3_f1600_avx2)
+
+#endif /* PLAT_X64_SIMD */
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === FIPS 202 Keccak permutation / x86-64 AVX-512 kernels */
+
+#include "plat_local.h"
+#include "sha3_api.h"
+
+#ifdef PLAT_X64_SIMD
+
+#include <immintrin.h>
+
+#define SHA3_F1600_AVX512 __attribute__((target("avx2,avx512f,avx512vl")))
+
+/* vector helpers: each 64-bit lane belongs to a different state */
+
+#define V8_XOR(x, y) _mm512_xor_si512(x, y)
+#define V8_XOR3(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0x96)
+#define V8_XNA(x, y, z) _mm512_ternarylogic_epi64(x, y, z, 0xD2) /* x^~y&z */
+#define V8_ROR(x, n) _mm512_rol_epi64(x, 64 - (n))
+
+/* chi on a row of five lanes */
+#define CHI_ROW8(x0, x1, x2, x3, x4) \
+  {                                  \
+    t = x0;                          \
+    u = x1;                          \
+    x0 = V8_XNA(x0, x1, x2);         \
+    x1 = V8_XNA(x1, x2, x3);         \
+    x2 = V8_XNA(x2, x3, x4);         \
+    x3 = V8_XNA(x3, x4, t);          \
+    x4 = V8_XNA(x4, t, u);           \
+  }
+
+/* eight permutations; lane i of state j is in x[8 * i + j] */
+
+SHA3_F1600_AVX512
+void keccak_f1600_x8_avx512(uint64_t x[8 * 25])
+{
+  __m512i s[25];
+  __m512i t, u, y0, y1, y2, y3, y4;
+  int i;
+
+  for (i = 0; i < 25; i++)
+  {
+    s[i] = _mm512_loadu_si512((const void *)&x[8 * i]);
+  }
+
+  for (i = 0; i < 24; i++)
+  {
+    /* Theta */
+
+    y4 = V8_XOR3(V8_XOR3(s[4], s[9], s[14]), s[19], s[24]);
+    y1 = V8_XOR3(V8_XOR3(s[1], s[6], s[11]), s[16], s[21]);
+    y3 = V8_XOR3(V8_XOR3(s[3], s[8], s[13]), s[18], s[23]);
+    y0 = V8_XOR3(V8_XOR3(s[0], s[5], s[10]), s[15], s[20]);
+    y2 = V8_XOR3(V8_XOR3(s[2], s[7], s[12]), s[17], s[22]);
+
+    t = V8_ROR(y4, 63);
+    y4 = V8_XOR(y4, V8_ROR(y1, 63));
+    y1 = V8_XOR(y1, V8_ROR(y3, 63));
+    y3 = V8_XOR(y3, V8_ROR(y0, 63));
+    y0 = V8_XOR(y0, V8_ROR(y2, 63));
+    y2 = V8_XOR(y2, t);
+
+    s[0] = V8_XOR(s[0], y4);
+    s[1] = V8_XOR(s[1], y0);
+    s[2] = V8_XOR(s[2], y1);
+    s[3] = V8_XOR(s[3], y2);
+    s[4] = V8_XOR(s[4], y3);
+    s[5] = V8_XOR(s[5], y4);
+    s[6] = V8_XOR(s[6], y0);
+    s[7] = V8_XOR(s[7], y1);
+    s[8] = V8_XOR(s[8], y2);
+    s[9] = V8_XOR(s[9], y3);
+    s[10] = V8_XOR(s[10], y4);
+    s[11] = V8_XOR(s[11], y0);
+    s[12] = V8_XOR(s[12], y1);
+    s[13] = V8_XOR(s[13], y2);
+    s[14] = V8_XOR(s[14], y3);
+    s[15] = V8_XOR(s[15], y4);
+    s[16] = V8_XOR(s[16], y0);
+    s[17] = V8_XOR(s[17], y1);
+    s[18] = V8_XOR(s[18], y2);
+    s[19] = V8_XOR(s[19], y3);
+    s[20] = V8_XOR(s[20], y4);
+    s[21] = V8_XOR(s[21], y0);
+    s[22] = V8_XOR(s[22], y1);
+    s[23] = V8_XOR(s[23], y2);
+    s[24] = V8_XOR(s[24], y3);
+
+    /* Rho Pi */
+
+    t = V8_ROR(s[1], 63);
+    s[1] = V8_ROR(s[6], 20);
+    s[6] = V8_ROR(s[9], 44);
+    s[9] = V8_ROR(s[22], 3);
+    s[22] = V8_ROR(s[14], 25);
+    s[14] = V8_ROR(s[20], 46);
+    s[20] = V8_ROR(s[2], 2);
+    s[2] = V8_ROR(s[12], 21);
+    s[12] = V8_ROR(s[13], 39);
+    s[13] = V8_ROR(s[19], 56);
+    s[19] = V8_ROR(s[23], 8);
+    s[23] = V8_ROR(s[15], 23);
+    s[15] = V8_ROR(s[4], 37);
+    s[4] = V8_ROR(s[24], 50);
+    s[24] = V8_ROR(s[21], 62);
+    s[21] = V8_ROR(s[8], 9);
+    s[8] = V8_ROR(s[16], 19);
+    s[16] = V8_ROR(s[5], 28);
+    s[5] = V8_ROR(s[3], 36);
+    s[3] = V8_ROR(s[18], 43);
+    s[18] = V8_ROR(s[17], 49);
+    s[17] = V8_ROR(s[11], 54);
+    s[11] = V8_ROR(s[7], 58);
+    s[7] = V8_ROR(s[10], 61);
+    s[10] = t;
+
+    /* Chi */
+
+    CHI_ROW8(s[0], s[1], s[2], s[3], s[4]);
+    CHI_ROW8(s[5], s[6], s[7], s[8], s[9]);
+    CHI_ROW8(s[10], s[11], s[12], s[13], s[14]);
+    CHI_ROW8(s[15], s[16], s[17], s[18], s[19]);
+    CHI_ROW8(s[20], s[21], s[22], s[23], s[24]);
+
+    /* Iota */
+
+    s[0] = V8_XOR(s[0], _mm512_set1_epi64(keccak_rc[i]));
+  }
+
+  for (i = 0; i < 25; i++)
+  {
+    _mm512_storeu_si512((void *)&x[8 * i], s[i]);
+  }
+}
+
+/* single state, one plane (five lanes x = 0..4) per zmm register */
+
+/* rho rotation amounts for lanes x = 0..4 of a plane */
+#define RHO_ROW8(r0, r1, r2, r3, r4) \
+  _mm512_set_epi64(0, 0, 0, r4, r3, r2, r1, r0)
+
+/* pi: output row c takes lane (x + 3c) mod 5 of input row x, at lane x */
+#define PI_IDX8(c)                                                     \
+  _mm512_set_epi64(0, 0, 0, (4 + 3 * (c)) % 5, (3 + 3 * (c)) % 5,      \
+                   (2 + 3 * (c)) % 5, 8 + (1 + 3 * (c)) % 5, (3 * (c)) % 5)
+
+#define PI_ROW8(c, b0, b1, b2, b3, b4)                    \
+  {                                                       \
+    t = PI_IDX8(c);                                       \
+    u = _mm512_permutex2var_epi64(b0, t, b1);             \
+    u = _mm512_mask_permutexvar_epi64(u, 0x04, t, b2);    \
+    u = _mm512_mask_permutexvar_epi64(u, 0x08, t, b3);    \
+    s##c = _mm512_mask_permutexvar_epi64(u, 0x10, t, b4); \
+  }
+
+/* chi on a plane; lane x gets x ^ (~(x + 1) & (x + 2)) */
+#define CHI_PLANE8(r)                                  \
+  {                                                    \
+    r = V8_XNA(r, _mm512_permutexvar_epi64(p1, r),     \
+               _mm512_permutexvar_epi64(p2, r));       \
+  }
+
+SHA3_F1600_AVX512
+void keccak_f1600_avx512(uint64_t x[25])
+{
+  const __m512i p1 = _mm512_set_epi64(0, 0, 0, 0, 4, 3, 2, 1);
+  const __m512i p2 = _mm512_set_epi64(0, 0, 0, 1, 0, 4, 3, 2);
+  const __m512i m1 = _mm512_set_epi64(0, 0, 0, 3, 2, 1, 0, 4);
+  __m512i s0, s1, s2, s3, s4;
+  __m512i b0, b1, b2, b3, b4;
+  __m512i t, u;
+  int i;
+
+  s0 = _mm512_maskz_loadu_epi64(0x1F, x);
+  s1 = _mm512_maskz_loadu_epi64(0x1F, x + 5);
+  s2 = _mm512_maskz_loadu_epi64(0x1F, x + 10);
+  s3 = _mm512_maskz_loadu_epi64(0x1F, x + 15);
+  s4 = _mm512_maskz_loadu_epi64(0x1F, x + 20);
+
+  for (i = 0; i < 24; i++)
+  {
+    /* Theta */
+
+    t = V8_XOR3(V8_XOR3(s0, s1, s2), s3, s4);
+    u = _mm512_rol_epi64(_mm512_permutexvar_epi64(p1, t), 1);
+    t = _mm512_permutexvar_epi64(m1, t);
+    s0 = V8_XOR3(s0, t, u);
+    s1 = V8_XOR3(s1, t, u);
+    s2 = V8_XOR3(s2, t, u);
+    s3 = V8_XOR3(s3, t, u);
+    s4 = V8_XOR3(s4, t, u);
+
+    /* Rho */
+
+    b0 = _mm512_rolv_epi64(s0, RHO_ROW8(0, 1, 62, 28, 27));
+    b1 = _mm512_rolv_epi64(s1, RHO_ROW8(36, 44, 6, 55, 20));
+    b2 = _mm512_rolv_epi64(s2, RHO_ROW8(3, 10, 43, 25, 39));
+    b3 = _mm512_rolv_epi64(s3, RHO_ROW8(41, 45, 15, 21, 8));
+    b4 = _mm512_rolv_epi64(s4, RHO_ROW8(18, 2, 61, 56, 14));
+
+    /* Pi */
+
+    PI_ROW8(0, b0, b1, b2, b3, b4);
+    PI_ROW8(1, b0, b1, b2, b3, b4);
+    PI_ROW8(2, b0, b1, b2, b3, b4);
+    PI_ROW8(3, b0, b1, b2, b3, b4);
+    PI_ROW8(4, b0, b1, b2, b3, b4);
+
+    /* Chi */
+
+    CHI_PLANE8(s0);
+    CHI_PLANE8(s1);
+    CHI_PLANE8(s2);
+    CHI_PLANE8(s3);
+    CHI_PLANE8(s4);
+
+    /* Iota */
+
+    s0 = V8_XOR(s0, _mm512_maskz_loadu_epi64(0x01, &keccak_rc[i]));
+  }
+
+  _mm512_mask_storeu_epi64(x, 0x1F, s0);
+  _mm512_mask_storeu_epi64(x + 5, 0x1F, s1);
+  _mm512_mask_storeu_epi64(x + 10, 0x1F, s2);
+  _mm512_mask_storeu_epi64(x + 15, 0x1F, s3);
+  _mm512_mask_storeu_epi64(x + 20, 0x1F, s4);
+}
+
+#else /* !PLAT_X64_SIMD */
+
+SLH_EMPTY_CU(sha3_f1600_avx512)
+
+#endif /* PLAT_X64_SIMD */
@@ -10,6 +10,27 @@
 #include "slh_var.h"
 #include "slh_sys.h"
 
+/* === Single parameter set build, e.g. */
+/* -DSLH_FIXED_PARAM=slh_dsa_sha2_128s . The hash instantiations are */
+/* compiled into this unit so that parameters become constants and the */
+/* hash callbacks direct (inlinable) calls. Other sets are rejected. */
+
+#ifdef SLH_FIXED_PARAM
+#define SLH_FIXED_UNIT
+#include "slh_sha2.c"
+#include "slh_shake.c"
+#define SLH_PRM(p) (&SLH_FIXED_PARAM)
+#define SLH_FIXED_CHECK(p, ret) \
+  if ((p) != &SLH_FIXED_PARAM)  \
+  {                             \
+    return ret;                 \
+  }                             \
+  p = &SLH_FIXED_PARAM;
+#else
+#define SLH_PRM(p) (p)
+#define SLH_FIXED_CHECK(p, ret)
+#endif
+
 /* === Internal */
 
 /* helper functions to compute "len = len1 + len2" */
@@ -43,16 +64,37 @@ static SLH_INLINE uint32_t gen_len2(const slh_param_t *prm)
   return len2;
 }
 
-static SLH_INLINE uint32_t get_len(const slh_param_t *prm)
+/* Fill in the derived layout of *prm from its core parameters. */
+
+void slh_param_layout(slh_param_t *prm)
 {
-  return get_len1(prm) + gen_len2(prm);
+  prm->len1 = get_len1(prm);
+  prm->len2 = gen_len2(prm);
+  prm->len = prm->len1 + prm->len2;
+
+  /* checksum encoding in wots_csum() */
+  prm->csum_shl = (8 - ((prm->len2 * prm->lg_w) & 7)) & 7;
+  prm->csum_sz = (prm->len2 * prm->lg_w + 7) / 8;
+
+  /* signature layout */
+  prm->xmss_sz = (prm->hp + prm->len) * prm->n;
+  prm->fors_sz = prm->k * (1 + prm->a) * prm->n;
+  prm->sig_sz = prm->n + prm->fors_sz + prm->d * prm->xmss_sz;
+
+  /* digest split in split_digest() */
+  prm->md_sz = (prm->k * prm->a + 7) / 8;
+  prm->tree_sz = (prm->h - prm->hp + 7) / 8;
+  prm->leaf_sz = (prm->hp + 7) / 8;
+  prm->tree_mask = 0;
+  if (prm->h - prm->hp > 0)
+  {
+    prm->tree_mask = ~UINT64_C(0) >> (64 - (prm->h - prm->hp));
+  }
+  prm->leaf_mask = (1 << prm->hp) - 1;
 }
 
 /* Return signature size in bytes for parameter set *prm. */
-size_t slh_sig_sz(const slh_param_t *prm)
-{
-  return (1 + prm->k * (1 + prm->a) + prm->h + prm->d * get_len(prm)) * prm->n;
-}
+size_t slh_sig_sz(const slh_param_t *prm) { return prm->sig_sz; }
 
 /* === Compute the base 2**b representation of X. */
 /* Algorithm 4: base_2b(X, b, out_len) */
@@ -90,51 +132,32 @@ static SLH_INLINE size_t base_2b(uint32_t *v, const uint8_t *x, uint32_t b,
 
 /* === Generate a WOTS+ signature on an n-byte message. */
 /* Algorithm 7: wots_sign(M, SK.seed, PK.seed, ADRS) */
+/* (see xmss_treehash, which signs while generating the leaf) */
 
 /* (wots_csum is a shared helper function for algorithms 7 and 8) */
 static void wots_csum(uint32_t *vm, const uint8_t *m, const slh_param_t *prm)
 {
   uint32_t csum, i, t;
-  uint32_t len1, len2;
-  uint8_t buf[4];
+  uint32_t len1 = prm->len1;
+  uint8_t buf[4], mz[SLH_MAX_N + 4];
 
-  len1 = get_len1(prm);
-  len2 = gen_len2(prm);
+  /* len1 * lg_w may exceed 8 * n; the extra bits read as zero */
+  memset(mz, 0, sizeof(mz));
+  memcpy(mz, m, prm->n);
+  base_2b(vm, mz, prm->lg_w, len1);
 
-  base_2b(vm, m, prm->lg_w, len1);
-  
   csum = 0;
   t = (1 << prm->lg_w) - 1;
   for (i = 0; i < len1; i++)
   {
     csum += t - vm[i];
   }
-  csum <<= (8 - ((len2 * prm->lg_w) & 7)) & 7;
+  csum <<= prm->csum_shl;
 
-  t = (len2 * prm->lg_w + 7) / 8;
   memset(buf, 0, sizeof(buf));
-  slh_tobyte(buf, csum, t);
+  slh_tobyte(buf, csum, prm->csum_sz);
 
-  base_2b(&vm[len1], buf, prm->lg_w, len2);
-}
-
-static size_t wots_sign(slh_var_t *var, uint8_t *sig, const uint8_t *m)
-{
-  const slh_param_t *prm = var->prm;
-  uint32_t i, len;
-  uint32_t vm[SLH_MAX_LEN];
-  size_t n = prm->n;
-
-  len = get_len(prm);
-  wots_csum(vm, m, prm);
-
-  for (i = 0; i < len; i++)
-  {
-    adrs_set_chain_address(var, i);
-    prm->wots_chain(var, sig, vm[i]);
-    sig += n;
-  }
-  return n * len;
+  base_2b(&vm[len1], buf, prm->lg_w, prm->len2);
 }
 
 /* === Compute a WOTS+ public key from a message and its signature. */
@@ -143,106 +166,240 @@ static size_t wots_sign(slh_var_t *var, uint8_t *sig, const uint8_t *m)
 static void wots_pk_from_sig(slh_var_t *var, uint8_t *pk, const uint8_t *sig,
                              const uint8_t *m)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   size_t n = prm->n;
   uint32_t i, t, len;
   uint32_t vm[SLH_MAX_LEN];
   uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
-  size_t tmp_sz;
+#ifdef PLAT_X64_SIMD
+  uint32_t ci[SLH_MAX_LEN], vs[SLH_MAX_LEN];
+#endif
 
   wots_csum(vm, m, prm);
 
-  len = get_len(prm);
+  len = prm->len;
   t = (1 << prm->lg_w) - 1;
-  tmp_sz = 0;
+#ifdef PLAT_X64_SIMD
+  /* all chains at once; their lengths differ */
+  for (i = 0; i < len; i++)
+  {
+    ci[i] = i;
+    vs[i] = t - vm[i];
+  }
+  prm->chain_x(var, tmp, sig, ci, vm, vs, len);
+#else
+  /* no multi-lane kernels; one chain at a time */
   for (i = 0; i < len; i++)
   {
     adrs_set_chain_address(var, i);
-    prm->chain(var, tmp + tmp_sz, sig + tmp_sz, vm[i], t - vm[i]);
-    tmp_sz += n;
+    prm->chain(var, tmp + i * n, sig + i * n, vm[i], t - vm[i]);
   }
+#endif
 
   adrs_set_type_and_clear_not_kp(var, ADRS_WOTS_PK);
-  prm->h_t(var, pk, tmp, tmp_sz);
+  prm->h_t(var, pk, tmp, len * n);
+}
+
+/* Hash the 2**zc leaves at "lv", first leaf index "i", level by level */
+/* (in place) into the subtree root lv[0]. The ADRS type is set by the */
+/* caller. Nodes of the authentication path of leaf "idx" below height */
+/* "z" are copied to "auth" (if not NULL) as they are produced. If "pt" */
+/* is set, the ancestors of leaf "idx" (and the root) are not computed. */
+
+static void tree_levels(slh_var_t *var, uint8_t *lv, uint32_t i, uint32_t zc,
+                        uint8_t *auth, uint32_t idx, uint32_t z, int pt)
+{
+  const slh_param_t *prm = SLH_PRM(var->prm);
+  size_t n = prm->n;
+  uint32_t k, s, q, c;
+
+  for (k = 0;; k++)
+  {
+    s = ((idx >> k) ^ 1) - (i >> k); /* sibling at height k */
+    if (auth != NULL && k < z && s < (1u << (zc - k)))
+    {
+      memcpy(auth + k * n, lv + s * n, n);
+    }
+    if (k == zc)
+    {
+      break;
+    }
+    adrs_set_tree_height(var, k + 1);
+    adrs_set_tree_index(var, i >> (k + 1));
+    c = 1u << (zc - k - 1);
+    q = pt ? (idx >> (k + 1)) - (i >> (k + 1)) : c; /* skipped node */
+    if (q >= c)
+    {
+      prm->h_h_x(var, lv, lv, c);
+      continue;
+    }
+    if (q > 0)
+    {
+      prm->h_h_x(var, lv, lv, q);
+    }
+    if (q + 1 < c)
+    {
+      adrs_set_tree_index(var, (i >> (k + 1)) + q + 1);
+      prm->h_h_x(var, lv + (q + 1) * n, lv + 2 * (q + 1) * n, c - q - 1);
+    }
+  }
 }
 
 /* === Compute the root of a Merkle subtree of WOTS+ public keys. */
 /* Algorithm 9: xmss_node(SK.seed, i, z, PK.seed, ADRS) */
 
-static void xmss_node(slh_var_t *var, uint8_t *node, uint32_t i, uint32_t z)
+/* If "sx" is not NULL, this also creates the XMSS signature of leaf */
+/* "idx" with WOTS+ digits "vm": the chains of that leaf are split at */
+/* vm[k] (Algorithm 7) and the authentication path nodes are recorded */
+/* as they are produced (Algorithm 10). If "node" is NULL, the root is */
+/* not needed; leaf "idx" and its ancestors are then not computed. */
+
+/* Subtrees of up to SLH_TREE_X leaves are hashed level by level with */
+/* the multi-lane callbacks; their leaves are generated SLH_LEAF_X at a */
+/* time (all chains, then all public key compressions). The subtree */
+/* roots are merged on a stack. */
+
+static void xmss_treehash(slh_var_t *var, uint8_t *node, uint32_t i,
+                          uint32_t z, uint8_t *sx, const uint32_t *vm,
+                          uint32_t idx)
 {
-  const slh_param_t *prm = var->prm;
-  uint32_t j, k, w1;
+  const slh_param_t *prm = SLH_PRM(var->prm);
+  uint32_t j, k, w1, b, nb, nc, zc, s;
+  uint32_t kp[SLH_LEAF_X * SLH_MAX_LEN], ci[SLH_LEAF_X * SLH_MAX_LEN];
+  uint32_t ws[SLH_LEAF_X * SLH_MAX_LEN];
   int p;
-  uint8_t *h0, h[SLH_MAX_HP][SLH_MAX_N];
-  uint8_t tmp[SLH_MAX_LEN * SLH_MAX_N];
-  uint8_t *sk;
+  uint8_t *h0, h[SLH_MAX_HP][SLH_MAX_N], lv[SLH_TREE_X * SLH_MAX_N];
+  uint8_t tmp[SLH_LEAF_X * SLH_MAX_LEN * SLH_MAX_N];
+  uint8_t *sk, *auth = NULL, rt[SLH_MAX_N];
   size_t n = prm->n;
-  size_t len = get_len(prm);
+  size_t len = prm->len;
+  int pt = 0;
+
+  if (sx != NULL)
+  {
+    auth = sx + len * n;
+    if (node == NULL)
+    {
+      node = rt; /* scratch; nothing on the path of "idx" is hashed */
+      pt = 1;
+    }
+  }
 
   p = -1;
   i <<= z;
   w1 = (1 << prm->lg_w) - 1;
-  for (j = 0; j < (1u << z); j++)
+  zc = z;
+  while ((1u << zc) > SLH_TREE_X)
+  {
+    zc--;
+  }
+  nc = 1u << zc;
+  nb = nc < SLH_LEAF_X ? nc : SLH_LEAF_X;
+  for (k = 0; k < nb * len; k++)
   {
-    adrs_set_key_pair_address(var, i);
+    ci[k] = k % len; /* chain addresses */
+  }
 
-    /* === Generate a WOTS+ public key. */
-    /* Algorithm 6: wots_PKgen(SK.seed, PK.seed, ADRS) */
-    sk = tmp;
-    for (k = 0; k < len; k++)
+  for (j = 0; j < (1u << z); j += nc)
+  {
+    for (b = 0; b < nc; b += nb)
     {
-      adrs_set_chain_address(var, k);
-      prm->wots_chain(var, sk, w1);
-      sk += n;
+      /* === Generate a WOTS+ public key. */
+      /* Algorithm 6: wots_PKgen(SK.seed, PK.seed, ADRS) */
+      s = sx != NULL && idx - (i + b) < nb ? idx - (i + b) : nb;
+      for (k = 0; k < nb * len; k++)
+      {
+        kp[k] = i + b + k / len;                 /* key pair addresses */
+        ws[k] = k / len == s ? vm[k % len] : w1; /* steps */
+      }
+      prm->wots_chain_x(var, tmp, kp, ci, ws, nb * len);
+
+      if (sx != NULL && s < nb)
+      {
+        /* signature values, then the rest of each chain */
+        sk = tmp + s * len * n;
+        memcpy(sx, sk, len * n);
+        for (k = 0; k < len && !pt; k++)
+        {
+          ws[k] = w1 - vm[k];
+        }
+        adrs_set_key_pair_address(var, idx);
+        if (!pt)
+        {
+          prm->chain_x(var, sk, sx, ci, vm, ws, len);
+        }
+      }
+      adrs_set_type_and_clear_not_kp(var, ADRS_WOTS_PK);
+      adrs_set_key_pair_address(var, i + b);
+      if (!pt || s >= nb)
+      {
+        prm->h_t_x(var, lv + b * n, tmp, len * n, nb);
+        continue;
+      }
+      /* leaf "idx" itself is not needed */
+      if (s > 0)
+      {
+        prm->h_t_x(var, lv + b * n, tmp, len * n, s);
+      }
+      if (s + 1 < nb)
+      {
+        adrs_set_key_pair_address(var, idx + 1);
+        prm->h_t_x(var, lv + (b + s + 1) * n, tmp + (s + 1) * len * n,
+                   len * n, nb - s - 1);
+      }
     }
-    adrs_set_type_and_clear_not_kp(var, ADRS_WOTS_PK);
+
+    /* subtree of nc leaves */
+    adrs_set_type_and_clear(var, ADRS_TREE);
+    tree_levels(var, lv, i, zc, auth, idx, z, pt);
     h0 = p >= 0 ? h[p] : node;
     p++;
-    prm->h_t(var, h0, tmp, len * n);
+    memcpy(h0, lv, n);
+    i += nc;
 
     /* this xmss_node() implementation is non-recursive */
-    for (k = 0; (j >> k) & 1; k++)
+    for (k = zc; ((j >> zc) >> (k - zc)) & 1; k++)
     {
       adrs_set_type_and_clear(var, ADRS_TREE);
       adrs_set_tree_height(var, k + 1);
-      adrs_set_tree_index(var, i >> (k + 1));
+      adrs_set_tree_index(var, (i - 1) >> (k + 1));
       p--;
       h0 = p >= 1 ? h[p - 1] : node;
+      if (pt && ((i - 1) >> (k + 1)) == (idx >> (k + 1)))
+      {
+        continue; /* ancestor of leaf "idx" */
+      }
       prm->h_h(var, h0, h0, h[p]);
+      if (auth != NULL && k + 1 < z &&
+          (((i - 1) >> (k + 1)) ^ 1) == (idx >> (k + 1)))
+      {
+        memcpy(auth + (k + 1) * n, h0, n);
+      }
     }
-    i++; /* advance index */
   }
 }
 
+static void xmss_node(slh_var_t *var, uint8_t *node, uint32_t i, uint32_t z)
+{
+  xmss_treehash(var, node, i, z, NULL, NULL, 0);
+}
+
 /* === Generate an XMSS signature. */
 /* Algorithm 10: xmss_sign(M, SK.seed, idx, PK.seed, ADRS) */
 
-static size_t xmss_sign(slh_var_t *var, uint8_t *sx, const uint8_t *m,
-                        uint32_t idx)
-{
-  const slh_param_t *prm = var->prm;
-  uint32_t j, k;
-  uint8_t *auth;
-  size_t sx_sz = 0;
-  size_t n = prm->n;
+/* Single traversal of the tree; also returns the XMSS root in "root", */
+/* which may be the same buffer as "m", unless "root" is NULL. */
 
-  sx_sz = get_len(prm) * n;
-  auth = sx + sx_sz;
-
-  for (j = 0; j < prm->hp; j++)
-  {
-    k = (idx >> j) ^ 1;
-    xmss_node(var, auth, k, j);
-    auth += n;
-  }
-  sx_sz += prm->hp * n;
+static size_t xmss_sign(slh_var_t *var, uint8_t *sx, uint8_t *root,
+                        const uint8_t *m, uint32_t idx)
+{
+  const slh_param_t *prm = SLH_PRM(var->prm);
+  uint32_t vm[SLH_MAX_LEN];
 
-  adrs_set_type_and_clear_not_kp(var, ADRS_WOTS_HASH);
-  adrs_set_key_pair_address(var, idx);
-  wots_sign(var, sx, m);
+  wots_csum(vm, m, prm);
+  xmss_treehash(var, root, 0, prm->hp, sx, vm, idx);
 
-  return sx_sz;
+  return prm->xmss_sz;
 }
 
 /* === Compute an XMSS public key from an XMSS signature. */
@@ -251,7 +408,7 @@ static size_t xmss_sign(slh_var_t *var, uint8_t *sx, const uint8_t *m,
 static void xmss_pk_from_sig(slh_var_t *var, uint8_t *root, uint32_t idx,
                              const uint8_t *sig, const uint8_t *m)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   size_t n = prm->n;
   uint32_t k;
   const uint8_t *auth;
@@ -262,7 +419,7 @@ static void xmss_pk_from_sig(slh_var_t *var, uint8_t *root, uint32_t idx,
   wots_pk_from_sig(var, root, sig, m);
   adrs_set_type_and_clear(var, ADRS_TREE);
 
-  auth = sig + (get_len(prm) * n);
+  auth = sig + (prm->len * n);
 
   for (k = 0; k < prm->hp; k++)
   {
@@ -287,24 +444,25 @@ static void xmss_pk_from_sig(slh_var_t *var, uint8_t *root, uint32_t idx,
 static size_t ht_sign(slh_var_t *var, uint8_t *sh, uint8_t *m, uint64_t i_tree,
                       uint32_t i_leaf)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   uint32_t j;
   size_t sx_sz;
 
+  /* each layer signs the root of the layer below; kept in m. The root */
+  /* of the top layer is PK.root and is not recomputed. */
   adrs_zero(var);
   adrs_set_tree_address(var, i_tree);
-  sx_sz = xmss_sign(var, sh, m, i_leaf);
+  sx_sz = xmss_sign(var, sh, prm->d > 1 ? m : NULL, m, i_leaf);
 
   for (j = 1; j < prm->d; j++)
   {
-    xmss_pk_from_sig(var, m, i_leaf, sh, m);
     sh += sx_sz;
 
-    i_leaf = i_tree & ((1 << prm->hp) - 1);
+    i_leaf = i_tree & prm->leaf_mask;
     i_tree >>= prm->hp;
     adrs_set_layer_address(var, j);
     adrs_set_tree_address(var, i_tree);
-    xmss_sign(var, sh, m, i_leaf);
+    xmss_sign(var, sh, j + 1 < prm->d ? m : NULL, m, i_leaf);
   }
 
   return sx_sz * prm->d;
@@ -316,7 +474,7 @@ static size_t ht_sign(slh_var_t *var, uint8_t *sh, uint8_t *m, uint64_t i_tree,
 static int ht_verify(slh_var_t *var, const uint8_t *m, const uint8_t *sig_ht,
                      uint64_t i_tree, uint32_t i_leaf)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   uint32_t j;
   uint8_t node[SLH_MAX_N] = {0};
   size_t st_sz;
@@ -326,11 +484,11 @@ static int ht_verify(slh_var_t *var, const uint8_t *m, const uint8_t *sig_ht,
 
   xmss_pk_from_sig(var, node, i_leaf, sig_ht, m);
 
-  st_sz = (prm->hp + get_len(prm)) * prm->n;
+  st_sz = prm->xmss_sz;
 
   for (j = 1; j < prm->d; j++)
   {
-    i_leaf = i_tree & ((1 << prm->hp) - 1);
+    i_leaf = i_tree & prm->leaf_mask;
     i_tree >>= prm->hp;
     adrs_set_layer_address(var, j);
     adrs_set_tree_address(var, i_tree);
@@ -349,63 +507,98 @@ static int ht_verify(slh_var_t *var, const uint8_t *m, const uint8_t *sig_ht,
 /* === Computes the root of a Merkle subtree of FORS public values. */
 /* Algorithm 15: fors_node(SK.seed, i, z, PK.seed, ADRS) */
 
-static void fors_node(slh_var_t *var, uint8_t *node, uint32_t i, uint32_t z)
+/* If "sf" is not NULL, this also creates the signature of leaf "idx" */
+/* of the tree: the secret value followed by the authentication path, */
+/* recorded as the nodes are produced (Algorithm 16). */
+
+/* Subtrees of up to SLH_TREE_X leaves are generated with */
+/* prm->fors_hash_x() and hashed level by level; their roots are merged */
+/* on a stack. */
+
+static void fors_treehash(slh_var_t *var, uint8_t *node, uint32_t i,
+                          uint32_t z, uint8_t *sf, uint32_t idx)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   uint8_t h[SLH_MAX_A][SLH_MAX_N], *h0;
-  uint32_t j, k;
+  uint8_t lv[SLH_TREE_X * SLH_MAX_N];
+  uint8_t *auth = NULL;
+  uint32_t j, k, nc, zc;
+  size_t n = prm->n;
   int p;
 
+  if (sf != NULL)
+  {
+    auth = sf + n;
+  }
+
   p = -1;
   i <<= z;
-  for (j = 0; j < (1u << z); j++)
+  zc = z;
+  while ((1u << zc) > SLH_TREE_X)
+  {
+    zc--;
+  }
+  nc = 1u << zc;
+  for (j = 0; j < (1u << z); j += nc)
   {
     /* fors_SKgen() + hash */
+    /* (the secret value of leaf "idx" goes to the signature) */
     adrs_set_tree_index(var, i);
+    prm->fors_hash_x(var, lv, 1, nc, sf != NULL && idx - i < nc ? sf : NULL,
+                     idx - i);
+
+    /* subtree of nc leaves */
+    tree_levels(var, lv, i, zc, auth, idx, z, 0);
     h0 = p >= 0 ? h[p] : node;
     p++;
-    prm->fors_hash(var, h0, 1);
+    memcpy(h0, lv, n);
+    i += nc;
 
     /* this fors_node() implementation is non-recursive */
-    for (k = 0; (j >> k) & 1; k++)
+    for (k = zc; ((j >> zc) >> (k - zc)) & 1; k++)
     {
       adrs_set_tree_height(var, k + 1);
-      adrs_set_tree_index(var, i >> (k + 1));
+      adrs_set_tree_index(var, (i - 1) >> (k + 1));
       p--;
       h0 = p > 0 ? h[p - 1] : node;
       prm->h_h(var, h0, h0, h[p]);
+      if (auth != NULL && k + 1 < z &&
+          (((i - 1) >> (k + 1)) ^ 1) == (idx >> (k + 1)))
+      {
+        memcpy(auth + (k + 1) * n, h0, n);
+      }
     }
-    i++; /* advance index */
   }
 }
 
 /* === Generates a FORS signature. */
 /* Algorithm 16: fors_sign(md, SK.seed, PK.seed, ADRS) */
 
-static size_t fors_sign(slh_var_t *var, uint8_t *sf, const uint8_t *md)
+/* Single traversal of each of the k trees; also returns the FORS */
+/* public key in "pk" (Algorithm 17 is not needed when signing). */
+
+static size_t fors_sign(slh_var_t *var, uint8_t *sf, uint8_t *pk,
+                        const uint8_t *md)
 {
-  const slh_param_t *prm = var->prm;
-  uint32_t i, j, s;
+  const slh_param_t *prm = SLH_PRM(var->prm);
+  uint32_t i;
   uint32_t vi[SLH_MAX_K];
+  uint8_t root[SLH_MAX_K * SLH_MAX_N];
   size_t n = prm->n;
+  size_t sf_sz = (1 + prm->a) * n;
 
   base_2b(vi, md, prm->a, prm->k);
 
   for (i = 0; i < prm->k; i++)
   {
-    /* fors_SKgen() */
-    adrs_set_tree_index(var, (i << prm->a) + vi[i]);
-    prm->fors_hash(var, sf, 0);
-    sf += n;
-
-    for (j = 0; j < prm->a; j++)
-    {
-      s = (vi[i] >> j) ^ 1;
-      fors_node(var, sf, (i << (prm->a - j)) + s, j);
-      sf += n;
-    }
+    fors_treehash(var, root + i * n, i, prm->a, sf, (i << prm->a) + vi[i]);
+    sf += sf_sz;
   }
-  return n * prm->k * (1 + prm->a);
+
+  adrs_set_type_and_clear_not_kp(var, ADRS_FORS_ROOTS);
+  prm->h_t(var, pk, root, prm->k * n);
+
+  return prm->fors_sz;
 }
 
 /* === Compute a FORS public key from a FORS signature. */
@@ -414,7 +607,7 @@ static size_t fors_sign(slh_var_t *var, uint8_t *sf, const uint8_t *md)
 static void fors_pk_from_sig(slh_var_t *var, uint8_t *pk, const uint8_t *sf,
                              const uint8_t *md)
 {
-  const slh_param_t *prm = var->prm;
+  const slh_param_t *prm = SLH_PRM(var->prm);
   uint32_t i, j, idx;
   uint32_t vi[SLH_MAX_K];
   uint8_t root[SLH_MAX_K * SLH_MAX_N];
@@ -477,6 +670,8 @@ int slh_keygen_internal(uint8_t *sk, uint8_t *pk, const uint8_t *sk_seed,
   slh_var_t var;
   size_t n = prm->n;
 
+  SLH_FIXED_CHECK(prm, -1)
+
   memcpy(sk, sk_seed, n);           /* SK_seed */
   memcpy(sk + n, sk_prf, n);        /* SK.prf */
   memcpy(sk + 2 * n, pk_seed, n);   /* PK.seed */
@@ -502,6 +697,8 @@ int slh_keygen(uint8_t *sk, uint8_t *pk, int (*rbg)(uint8_t *x, size_t xlen),
   uint8_t pk_root[SLH_MAX_N];
   size_t n = prm->n;
 
+  SLH_FIXED_CHECK(prm, -1)
+
   rbg(sk, 3 * n);                   /* SK.seed || SK.prf || PK.seed */
   memcpy(pk, sk + 2 * n, n);        /* PK.seed */
   memset(sk + 3 * n, 0x00, n);      /* PK.root not generated yet */
@@ -524,19 +721,11 @@ int slh_keygen(uint8_t *sk, uint8_t *pk, int (*rbg)(uint8_t *x, size_t xlen),
 static void split_digest(uint64_t *i_tree, uint32_t *i_leaf,
                          const uint8_t *digest, const slh_param_t *prm)
 {
-  size_t md_sz = (prm->k * prm->a + 7) / 8;
-  const uint8_t *pi_tree = digest + md_sz;
-  size_t i_tree_sz = (prm->h - prm->hp + 7) / 8;
-  size_t i_leaf_sz = (prm->hp + 7) / 8;
-  const uint8_t *pi_leaf = pi_tree + i_tree_sz;
-
-  *i_tree = slh_toint(pi_tree, i_tree_sz);
-  *i_leaf = slh_toint(pi_leaf, i_leaf_sz);
-  if ((prm->h - prm->hp) != 64)
-  {
-    *i_tree &= (UINT64_C(1) << (prm->h - prm->hp)) - UINT64_C(1);
-  }
-  *i_leaf &= (1 << prm->hp) - 1;
+  const uint8_t *pi_tree = digest + prm->md_sz;
+  const uint8_t *pi_leaf = pi_tree + prm->tree_sz;
+
+  *i_tree = slh_toint(pi_tree, prm->tree_sz) & prm->tree_mask;
+  *i_leaf = slh_toint(pi_leaf, prm->leaf_sz) & prm->leaf_mask;
 }
 
 /* Core signing function that just takes in "digest" and an already */
@@ -552,7 +741,7 @@ static size_t slh_sign_digest(slh_var_t *var, uint8_t *sig,
   uint8_t pk_fors[SLH_MAX_N] = {0};
   size_t sig_sz;
 
-  split_digest(&i_tree, &i_leaf, digest, var->prm);
+  split_digest(&i_tree, &i_leaf, digest, SLH_PRM(var->prm));
 
   adrs_zero(var);
   adrs_set_tree_address(var, i_tree);
@@ -560,8 +749,7 @@ static size_t slh_sign_digest(slh_var_t *var, uint8_t *sig,
   adrs_set_key_pair_address(var, i_leaf);
 
   /* SIG_FORS */
-  sig_sz = fors_sign(var, sig, md);
-  fors_pk_from_sig(var, pk_fors, sig, md);
+  sig_sz = fors_sign(var, sig, pk_fors, md);
 
   /* SIG_HT */
   sig += sig_sz;
@@ -581,6 +769,8 @@ size_t slh_sign_internal(uint8_t *sig, const uint8_t *m, size_t m_sz,
   uint8_t digest[SLH_MAX_M];
   size_t sig_sz;
 
+  SLH_FIXED_CHECK(prm, 0)
+
   /* set up secret key etc */
   prm->mk_var(&var, NULL, sk, prm);
 
@@ -615,6 +805,8 @@ size_t slh_sign(uint8_t *sig, const uint8_t *m, size_t m_sz, const uint8_t *ctx,
   uint8_t digest[SLH_MAX_M] = {0};
   size_t sig_sz;
 
+  SLH_FIXED_CHECK(prm, 0)
+
   if (ctx_sz > 255)
   {
     return 0;
@@ -648,9 +840,9 @@ size_t slh_sign(uint8_t *sig, const uint8_t *m, size_t m_sz, const uint8_t *ctx,
 /* most of Algorithm 20: slh_verify_internal(M, SIG, PK) */
 
 static int slh_verify_digest(slh_var_t *var, const uint8_t *digest,
-                             const uint8_t *sig, size_t sig_sz,
-                             const slh_param_t *prm)
+                             const uint8_t *sig, size_t sig_sz)
 {
+  const slh_param_t *prm = SLH_PRM(var->prm);
   uint8_t pk_fors[SLH_MAX_N] = { 0 };
   const uint8_t *sig_fors;
   const uint8_t *sig_ht;
@@ -659,10 +851,10 @@ static int slh_verify_digest(slh_var_t *var, const uint8_t *digest,
   uint32_t i_leaf = 0;
 
   sig_fors = sig + prm->n;
-  sig_ht = sig + ((1 + prm->k * (1 + prm->a)) * prm->n);
+  sig_ht = sig_fors + prm->fors_sz;
 
   /* check signature length */
-  if (sig_sz != slh_sig_sz(prm))
+  if (sig_sz != prm->sig_sz)
   {
     return 0; /* false */
   }
@@ -688,11 +880,13 @@ int slh_verify_internal(const uint8_t *m, size_t m_sz, const uint8_t *sig,
   slh_var_t var;
   uint8_t digest[SLH_MAX_M];
 
+  SLH_FIXED_CHECK(prm, 0)
+
   /* use Hmsg directly */
   prm->mk_var(&var, pk, NULL, prm);
   prm->h_msg(&var, digest, sig, m, m_sz, NULL, SLH_CTX_SZ_NO_CONTEXT);
 
-  return slh_verify_digest(&var, digest, sig, sig_sz, prm);
+  return slh_verify_digest(&var, digest, sig, sig_sz);
 }
 
 /* === Verifies a pure SLH-DSA signature. */
@@ -705,6 +899,8 @@ int slh_verify(const uint8_t *m, size_t m_sz, const uint8_t *sig, size_t sig_sz,
   slh_var_t var;
   uint8_t digest[SLH_MAX_M];
 
+  SLH_FIXED_CHECK(prm, 0)
+
   if (ctx_sz > 255)
   {
     return 0; /* false */
@@ -714,5 +910,5 @@ int slh_verify(const uint8_t *m, size_t m_sz, const uint8_t *sig, size_t sig_sz,
   prm->mk_var(&var, pk, NULL, prm);
   prm->h_msg(&var, digest, sig, m, m_sz, ctx, ctx_sz);
 
-  return slh_verify_digest(&var, digest, sig, sig_sz, prm);
+  return slh_verify_digest(&var, digest, sig, sig_sz);
 }
@@ -41,13 +41,35 @@ struct slh_param_s
   uint32_t lg_w; /* Number of bits in chain index (WOTS+) */
   uint32_t m;    /* Length in bytes of message digest. */
 
+  /* derived layout; see slh_param_layout() */
+  uint32_t len1;      /* Number of message chains (WOTS+). */
+  uint32_t len2;      /* Number of checksum chains (WOTS+). */
+  uint32_t len;       /* Total number of chains len1 + len2 (WOTS+). */
+  uint32_t csum_shl;  /* Left shift of checksum (WOTS+). */
+  uint32_t csum_sz;   /* Length in bytes of checksum (WOTS+). */
+  uint32_t xmss_sz;   /* XMSS signature size (len + hp) * n in bytes. */
+  uint32_t fors_sz;   /* FORS signature size k * (1 + a) * n in bytes. */
+  uint32_t sig_sz;    /* SLH-DSA signature size in bytes. */
+  uint32_t md_sz;     /* Bytes of digest for FORS indices. */
+  uint32_t tree_sz;   /* Bytes of digest for tree index. */
+  uint32_t leaf_sz;   /* Bytes of digest for leaf index. */
+  uint64_t tree_mask; /* Tree index mask 2**(h - hp) - 1. */
+  uint32_t leaf_mask; /* Leaf index mask 2**hp - 1. */
+
   /* hash function instantation */
   void (*mk_var)(slh_var_t *var, const uint8_t *pk, const uint8_t *sk,
                  const slh_param_t *prm);
   void (*chain)(slh_var_t *var, uint8_t *tmp, const uint8_t *x, uint32_t i,
                 uint32_t s);
+  void (*chain_x)(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
+                  const uint32_t *ci, const uint32_t *i, const uint32_t *s,
+                  uint32_t nx);
   void (*wots_chain)(slh_var_t *var, uint8_t *tmp, uint32_t s);
+  void (*wots_chain_x)(slh_var_t *var, uint8_t *tmp, const uint32_t *kp,
+                       const uint32_t *ci, const uint32_t *s, uint32_t nx);
   void (*fors_hash)(slh_var_t *var, uint8_t *tmp, uint32_t s);
+  void (*fors_hash_x)(slh_var_t *var, uint8_t *tmp, uint32_t s, uint32_t nx,
+                      uint8_t *sk, uint32_t si);
   void (*h_msg)(slh_var_t *var, uint8_t *h, const uint8_t *r, const uint8_t *m,
                 size_t m_sz, const uint8_t *ctx, size_t ctx_sz);
   void (*prf)(slh_var_t *var, uint8_t *h);
@@ -56,8 +78,15 @@ struct slh_param_s
                   size_t ctx_sz);
   void (*h_f)(slh_var_t *var, uint8_t *h, const uint8_t *m1);
   void (*h_h)(slh_var_t *var, uint8_t *h, const uint8_t *m1, const uint8_t *m2);
+  void (*h_h_x)(slh_var_t *var, uint8_t *h, const uint8_t *m, uint32_t nx);
   void (*h_t)(slh_var_t *var, uint8_t *h, const uint8_t *m, size_t m_sz);
+  void (*h_t_x)(slh_var_t *var, uint8_t *h, const uint8_t *m, size_t m_sz,
+                uint32_t nx);
 };
 
+/* Fill in the derived layout of *prm from its core parameters. The */
+/* standard parameter sets have it initialized statically. */
+void slh_param_layout(slh_param_t *prm);
+
 /* _SLH_PARAM_H_ */
 #endif
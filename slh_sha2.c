@@ -11,6 +11,9 @@
 #include "slh_adrs.h"
 #include "slh_var.h"
 
+/* with SLH_FIXED_PARAM, this file is compiled as a part of slh_dsa.c */
+#if !defined(SLH_FIXED_PARAM) || defined(SLH_FIXED_UNIT)
+
 /* Cat 1: Hmsg(R, PK.seed, PK.root, M) = */
 /* MGF1-SHA-256(R || PK.seed || SHA-256(R ||PK.seed || PK.root || */
 /* M), m) */
@@ -152,21 +155,70 @@ static void sha2_512_adrsc(sha2_512_t *sha2, const slh_var_t *var)
   sha2_512_update(sha2, buf, 22);
 }
 
+/* Single compression from the PK.seed midstate: "blk" is a precomputed */
+/* padded block, completed with ADRSc || m1 || m2 (m2 may be NULL). */
+
+static void sha2_256_blk(slh_var_t *var, uint8_t *h, const uint32_t *blk,
+                         const uint8_t *m1, const uint8_t *m2)
+{
+  uint32_t sp[8], mp[16];
+  uint8_t *bp = (uint8_t *)mp;
+  size_t n = var->prm->n;
+  size_t l = m2 == NULL ? 22 + n : 22 + 2 * n;
+
+  memcpy(sp, var->sha2_256_pk_seed.s, 32);
+  adrsc_22(var, bp);
+  memcpy(bp + 22, m1, n);
+  if (m2 != NULL)
+  {
+    memcpy(bp + 22 + n, m2, n);
+  }
+  memcpy(bp + l, (const uint8_t *)blk + l, 64 - l);
+  sha2_256_compress_blocks(sp, bp, 1);
+  memcpy(h, sp, n);
+}
+
+static void sha2_512_blk(slh_var_t *var, uint8_t *h, const uint64_t *blk,
+                         const uint8_t *m1, const uint8_t *m2)
+{
+  uint64_t sp[8], mp[16];
+  uint8_t *bp = (uint8_t *)mp;
+  size_t n = var->prm->n;
+  size_t l = 22 + 2 * n;
+
+  memcpy(sp, var->sha2_512_pk_seed.s, 64);
+  adrsc_22(var, bp);
+  memcpy(bp + 22, m1, n);
+  memcpy(bp + 22 + n, m2, n);
+  memcpy(bp + l, (const uint8_t *)blk + l, 128 - l);
+  sha2_512_compress_blocks(sp, bp, 1);
+  memcpy(h, sp, n);
+}
+
+/* padding for a single "blk_sz" block of "m_sz" bytes after the midstate */
+
+static void sha2_pad_blk(void *blk, size_t blk_sz, size_t m_sz)
+{
+  uint8_t *bp = (uint8_t *)blk;
+  uint64_t x = ((uint64_t)(blk_sz + m_sz)) << 3; /* length in bits */
+  size_t i = blk_sz;
+
+  memset(bp, 0x00, blk_sz);
+  bp[m_sz] = 0x80;
+  while (x > 0)
+  {
+    bp[--i] = x & 0xFF;
+    x >>= 8;
+  }
+}
+
 /* Cat 1, 3, 5: PRF(PK.seed, SK.seed, ADRS) = */
 /* Trunc_n(SHA-256(PK.seed || toByte(0, 64 − n) || ADRSc || */
 /* SK.seed)) */
 
 static void sha2_256_prf(slh_var_t *var, uint8_t *h)
 {
-  sha2_256_t sha2;
-  size_t n = var->prm->n;
-
-  sha2_256_copy(&sha2, &var->sha2_256_pk_seed);
-  sha2_256_adrsc(&sha2, var);
-  sha2_256_update(&sha2, var->sk_seed, n);
-  sha2_256_final_pad(&sha2);
-  sha2_256_compress(sha2.s);
-  memcpy(h, sha2.s, n);
+  sha2_256_blk(var, h, var->sha2_256_f_blk, var->sk_seed, NULL);
 }
 
 /* Cat 1: PRFmsg(SK.prf, opt_rand, M) = */
@@ -283,7 +335,7 @@ static void sha2_256_tl(slh_var_t *var, uint8_t *h, const uint8_t *m,
 
 static void sha2_256_f(slh_var_t *var, uint8_t *h, const uint8_t *m1)
 {
-  sha2_256_tl(var, h, m1, var->prm->n);
+  sha2_256_blk(var, h, var->sha2_256_f_blk, m1, NULL);
 }
 
 /* Cat 1: H(PK.seed, ADRS, M2 ) = */
@@ -292,14 +344,7 @@ static void sha2_256_f(slh_var_t *var, uint8_t *h, const uint8_t *m1)
 static void sha2_256_h(slh_var_t *var, uint8_t *h, const uint8_t *m1,
                        const uint8_t *m2)
 {
-  sha2_256_t sha2;
-  size_t n = var->prm->n;
-
-  sha2_256_copy(&sha2, &var->sha2_256_pk_seed);
-  sha2_256_adrsc(&sha2, var);
-  sha2_256_update(&sha2, m1, n);
-  sha2_256_update(&sha2, m2, n);
-  sha2_256_final_len(&sha2, h, n);
+  sha2_256_blk(var, h, var->sha2_256_h_blk, m1, m2);
 }
 
 /* Cat 3, 5: Tl(PK.seed, ADRS, Ml ) = */
@@ -323,14 +368,212 @@ static void sha2_512_tl(slh_var_t *var, uint8_t *h, const uint8_t *m,
 static void sha2_512_h(slh_var_t *var, uint8_t *h, const uint8_t *m1,
                        const uint8_t *m2)
 {
-  sha2_512_t sha2;
+  sha2_512_blk(var, h, var->sha2_512_h_blk, m1, m2);
+}
+
+/* bytes "off" .. "off" + "blk_sz" - 1 of ADRSc || M || padding, the */
+/* part of the message that follows the "blk_sz"-byte PK.seed block */
+
+static void sha2_msg_blk(uint8_t *bp, size_t blk_sz, size_t off,
+                         const uint8_t *ac, const uint8_t *m, size_t m_sz)
+{
+  size_t l = 22 + m_sz;
+  size_t end = (l + 1 + blk_sz / 8 + blk_sz - 1) / blk_sz * blk_sz;
+  size_t a, b;
+  uint64_t x;
+
+  memset(bp, 0x00, blk_sz);
+  if (off == 0)
+  {
+    memcpy(bp, ac, 22);
+  }
+  a = off > 22 ? off : 22;
+  b = off + blk_sz < l ? off + blk_sz : l;
+  if (a < b)
+  {
+    memcpy(bp + a - off, m + a - 22, b - a);
+  }
+  if (l >= off && l < off + blk_sz)
+  {
+    bp[l - off] = 0x80;
+  }
+  if (off + blk_sz == end)
+  {
+    x = ((uint64_t)(blk_sz + l)) << 3; /* length in bits */
+    for (a = blk_sz; x > 0; x >>= 8)
+    {
+      bp[--a] = x & 0xFF;
+    }
+  }
+}
+
+/* Multi-lane T_l: "nx" messages of "m_sz" bytes at "m" + j * m_sz, with */
+/* key pair addresses counting up from the one in ADRS, to "h" + j * n. */
+/* "iv" is the PK.seed midstate; lanes beyond "nx" repeat the first. */
+
+static void sha2_tl_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                      size_t m_sz, uint32_t nx, const void *iv, size_t iv_sz,
+                      size_t blk_sz, uint32_t lanes,
+                      void (*compress_x)(void *v[], uint32_t act))
+{
+  uint64_t v[16][(64 + 128) / 8];
+  uint8_t ac[16][22];
+  void *vp[16];
   size_t n = var->prm->n;
+  size_t nblk = (22 + m_sz + 1 + blk_sz / 8 + blk_sz - 1) / blk_sz;
+  size_t b;
+  uint32_t i, j, k, l, kp;
 
-  sha2_512_copy(&sha2, &var->sha2_512_pk_seed);
-  sha2_512_adrsc(&sha2, var);
-  sha2_512_update(&sha2, m1, n);
-  sha2_512_update(&sha2, m2, n);
-  sha2_512_final_len(&sha2, h, n);
+  kp = adrs_get_key_pair_address(var);
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+    for (k = 0; k < lanes; k++)
+    {
+      vp[k] = v[k];
+      memcpy(v[k], iv, iv_sz);
+      if (k < l)
+      {
+        adrs_set_key_pair_address(var, kp + j + k);
+        adrsc_22(var, ac[k]);
+      }
+    }
+    for (b = 0; b < nblk; b++)
+    {
+      for (k = 0; k < lanes; k++)
+      {
+        i = k < l ? k : 0;
+        sha2_msg_blk((uint8_t *)v[k] + iv_sz, blk_sz, b * blk_sz, ac[i],
+                     m + (j + i) * m_sz, m_sz);
+      }
+      compress_x(vp, (1u << l) - 1);
+    }
+    for (k = 0; k < l; k++)
+    {
+      memcpy(h + (j + k) * n, v[k], n);
+    }
+  }
+  adrs_set_key_pair_address(var, kp);
+}
+
+static void sha2_256_tl_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                          size_t m_sz, uint32_t nx)
+{
+  uint32_t lanes = sha2_256_lanes();
+  uint32_t j, kp;
+
+  if (lanes == 1)
+  {
+    kp = adrs_get_key_pair_address(var);
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_key_pair_address(var, kp + j);
+      sha2_256_tl(var, h + j * var->prm->n, m + j * m_sz, m_sz);
+    }
+    adrs_set_key_pair_address(var, kp);
+    return;
+  }
+  sha2_tl_x(var, h, m, m_sz, nx, var->sha2_256_pk_seed.s, 32, 64, lanes,
+            lanes == 16 ? sha2_256_compress_x16 : sha2_256_compress_x8);
+}
+
+static void sha2_512_tl_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                          size_t m_sz, uint32_t nx)
+{
+  uint32_t lanes = sha2_512_lanes();
+  uint32_t j, kp;
+
+  if (lanes == 1)
+  {
+    kp = adrs_get_key_pair_address(var);
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_key_pair_address(var, kp + j);
+      sha2_512_tl(var, h + j * var->prm->n, m + j * m_sz, m_sz);
+    }
+    adrs_set_key_pair_address(var, kp);
+    return;
+  }
+  sha2_tl_x(var, h, m, m_sz, nx, var->sha2_512_pk_seed.s, 64, 128, lanes,
+            lanes == 8 ? sha2_512_compress_x8 : sha2_512_compress_x4);
+}
+
+/* Multi-lane H: "nx" node pairs at "m" + 2 * j * n, with tree indices */
+/* counting up from the one in ADRS, to "h" + j * n ("h" may be "m"). */
+/* "blk" is the padded block template; groups of fewer than "min_l" */
+/* pairs use the single-lane "h_h". */
+
+static void sha2_h_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                     uint32_t nx, const void *iv, size_t iv_sz,
+                     const void *blk, size_t blk_sz, uint32_t lanes,
+                     uint32_t min_l,
+                     void (*compress_x)(void *v[], uint32_t act),
+                     void (*h_h)(slh_var_t *var, uint8_t *h,
+                                 const uint8_t *m1, const uint8_t *m2))
+{
+  uint64_t v[16][(64 + 128) / 8];
+  void *vp[16];
+  uint8_t *bp;
+  size_t n = var->prm->n;
+  uint32_t i, j, k, l, ti;
+
+  ti = adrs_get_tree_index(var);
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+    if (l < min_l)
+    {
+      for (k = j; k < j + l; k++)
+      {
+        adrs_set_tree_index(var, ti + k);
+        h_h(var, h + k * n, m + 2 * k * n, m + (2 * k + 1) * n);
+      }
+      continue;
+    }
+
+    /* all inputs of the group are read before any output is written */
+    for (k = 0; k < lanes; k++)
+    {
+      i = k < l ? j + k : j;
+      bp = (uint8_t *)v[k];
+      vp[k] = bp;
+      adrs_set_tree_index(var, ti + i);
+      memcpy(bp, iv, iv_sz);
+      adrsc_22(var, bp + iv_sz);
+      memcpy(bp + iv_sz + 22, m + 2 * i * n, 2 * n);
+      memcpy(bp + iv_sz + 22 + 2 * n, (const uint8_t *)blk + 22 + 2 * n,
+             blk_sz - 22 - 2 * n);
+    }
+    compress_x(vp, (1u << l) - 1);
+    for (k = 0; k < l; k++)
+    {
+      memcpy(h + (j + k) * n, v[k], n);
+    }
+  }
+  adrs_set_tree_index(var, ti);
+}
+
+static void sha2_256_h_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                         uint32_t nx)
+{
+  uint32_t lanes = sha2_256_lanes();
+
+  /* groups under half the lanes are faster as single compressions */
+  sha2_h_x(var, h, m, nx, var->sha2_256_pk_seed.s, 32, var->sha2_256_h_blk,
+           64, lanes, lanes == 1 ? 2 : lanes / 2,
+           lanes == 16 ? sha2_256_compress_x16 : sha2_256_compress_x8,
+           sha2_256_h);
+}
+
+static void sha2_512_h_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                         uint32_t nx)
+{
+  uint32_t lanes = sha2_512_lanes();
+
+  sha2_h_x(var, h, m, nx, var->sha2_512_pk_seed.s, 64, var->sha2_512_h_blk,
+           128, lanes, 2,
+           lanes == 8 ? sha2_512_compress_x8 : sha2_512_compress_x4,
+           sha2_512_h);
 }
 
 /* create a context */
@@ -361,12 +604,18 @@ static void sha2_mk_var(slh_var_t *var, const uint8_t *pk, const uint8_t *sk,
   sha2_256_init(&var->sha2_256_pk_seed);
   sha2_256_update(&var->sha2_256_pk_seed, var->pk_seed, n);
   sha2_256_update(&var->sha2_256_pk_seed, buf, 64 - n);
+  sha2_pad_blk(var->sha2_256_f_blk, 64, 22 + n);
 
   if (n > 16)
   {
     sha2_512_init(&var->sha2_512_pk_seed);
     sha2_512_update(&var->sha2_512_pk_seed, var->pk_seed, n);
     sha2_512_update(&var->sha2_512_pk_seed, buf, 128 - n);
+    sha2_pad_blk(var->sha2_512_h_blk, 128, 22 + 2 * n);
+  }
+  else
+  {
+    sha2_pad_blk(var->sha2_256_h_blk, 64, 22 + 2 * n);
   }
 
   /* local ADRS buffer */
@@ -379,12 +628,9 @@ static void sha2_mk_var(slh_var_t *var, const uint8_t *pk, const uint8_t *sk,
 static void sha2_256_chain(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
                            uint32_t i, uint32_t s)
 {
-  uint32_t j;
+  uint32_t mp[16];
+  uint8_t *bp = (uint8_t *)mp;
   size_t n = var->prm->n;
-  sha2_256_t sha2;
-  uint32_t sp[8 + 24];
-  uint8_t *mp = (uint8_t *)&sp[8];
-  uint8_t *op = (uint8_t *)&sha2.s[8];
 
   /* these cases exist */
   if (s == 0)
@@ -396,47 +642,267 @@ static void sha2_256_chain(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
   /* set initial address */
   adrs_set_hash_address(var, i);
 
-  /* initial set-up */
-  sha2_256_copy(&sha2, &var->sha2_256_pk_seed);
-  sha2_256_adrsc(&sha2, var);
-  sha2_256_update(&sha2, x, n);
-  if (s == 1)
+  /* block is ADRSc || X || padding; only X and the hash address change */
+  adrsc_22(var, bp);
+  memcpy(bp + 22, x, n);
+  memcpy(bp + 22 + n, (const uint8_t *)var->sha2_256_f_blk + 22 + n,
+         64 - 22 - n);
+  sha2_256_chain_blocks(tmp, var->sha2_256_pk_seed.s, bp, 22, n, s);
+}
+
+/* Combination WOTS PRF + Chain */
+
+static void sha2_256_wots_chain(slh_var_t *var, uint8_t *tmp, uint32_t s)
+{
+  uint32_t mp[16];
+  uint8_t *bp = (uint8_t *)mp;
+  size_t n = var->prm->n;
+
+  /* PRF secret key; same block layout as F */
+  adrs_set_type(var, ADRS_WOTS_PRF);
+  adrs_set_tree_index(var, 0);
+  adrsc_22(var, bp);
+  memcpy(bp + 22, var->sk_seed, n);
+  memcpy(bp + 22 + n, (const uint8_t *)var->sha2_256_f_blk + 22 + n,
+         64 - 22 - n);
+  sha2_256_chain_blocks(tmp, var->sha2_256_pk_seed.s, bp, 22, n, 1);
+
+  /* chain; the ADRSc type byte changes, hash address stays 0 */
+  adrs_set_type(var, ADRS_WOTS_HASH);
+  adrs_set_tree_index(var, 0);
+  if (s > 0)
   {
-    /* just one hash */
-    sha2_256_final_len(&sha2, tmp, n);
-    return;
+    bp[9] = ADRS_WOTS_HASH;
+    memcpy(bp + 22, tmp, n);
+    sha2_256_chain_blocks(tmp, var->sha2_256_pk_seed.s, bp, 22, n, s);
+  }
+}
+
+/* "lanes" (16 or 8, see sha2_256_lanes()) independent compressions; */
+/* only those in the bit mask "act" are used */
+
+static void sha2_256_compress_xl(void *v[16], uint32_t lanes, uint32_t act)
+{
+  if (lanes == 16)
+  {
+    sha2_256_compress_x16(v, act);
+  }
+  else
+  {
+    sha2_256_compress_x8(v, act);
   }
-  sha2_256_final_pad(&sha2);
-  memcpy(sp, sha2.s, sizeof(sp));
-  sha2_256_compress(sp);
+}
+
+#ifdef PLAT_X64_SIMD
 
-  /* iteration */
-  for (j = 1; j < s; j++)
+/* Multi-lane chain over "lanes" (16 or 8) lanes: "nx" chains of the key */
+/* pair in ADRS, chain address ci[j], from "x" + j * n at step i[j] for */
+/* s[j] steps to "tmp" + j * n. */
+/* A lane that finishes its chain is refilled with the next one; when */
+/* no chains are left and under half of the lanes are busy, the rest */
+/* are completed with single compressions. */
+
+static void sha2_256_chain_xl(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
+                              const uint32_t *ci, const uint32_t *i,
+                              const uint32_t *s, uint32_t nx, uint32_t lanes)
+{
+  uint32_t v[16][(32 + 64) / 4];
+  uint32_t lc[16], lt[16]; /* chain in lane, steps done */
+  void *vp[16];
+  uint8_t *bp;
+  size_t n = var->prm->n;
+  uint32_t c, k, t, busy, act;
+
+  memset(v, 0x00, sizeof(v));
+  for (k = 0; k < lanes; k++)
   {
-    memcpy(mp + 22, sp, n);        /* copy result back to input */
-    slh_tobyte(mp + 18, i + j, 4); /* hash address, last part of ADSc */
-    memcpy(sp, sha2.s, 32 + 18);   /* PK.seed compressed, start of ADRSc */
-    memcpy(mp + 22 + n, op + 22 + n, 64 - 22 - n); /* padding */
-    sha2_256_compress(sp);
+    vp[k] = v[k];
+    lc[k] = nx; /* idle */
   }
 
-  /* final output */
-  memcpy(tmp, sp, n);
+  c = 0;
+  while (1)
+  {
+    busy = 0;
+    act = 0;
+    for (k = 0; k < lanes; k++)
+    {
+      bp = (uint8_t *)v[k];
+      if (lc[k] < nx && ++lt[k] == s[lc[k]])
+      {
+        memcpy(tmp + lc[k] * n, bp, n); /* lane done */
+        lc[k] = nx;
+      }
+      if (lc[k] < nx)
+      {
+        /* next step: chaining value and hash address */
+        t = i[lc[k]] + lt[k];
+        memcpy(bp + 32 + 22, bp, n);
+      }
+      else
+      {
+        /* refill; zero-step chains are copies */
+        while (c < nx && s[c] == 0)
+        {
+          memcpy(tmp + c * n, x + c * n, n);
+          c++;
+        }
+        if (c == nx)
+        {
+          continue;
+        }
+        lc[k] = c;
+        lt[k] = 0;
+        t = i[c];
+        adrs_set_chain_address(var, ci[c]);
+        adrsc_22(var, bp + 32);
+        memcpy(bp + 32 + 22, x + c * n, n);
+        memcpy(bp + 32 + 22 + n,
+               (const uint8_t *)var->sha2_256_f_blk + 22 + n, 64 - 22 - n);
+        c++;
+      }
+      bp[32 + 18] = t >> 24;
+      bp[32 + 19] = (t >> 16) & 0xFF;
+      bp[32 + 20] = (t >> 8) & 0xFF;
+      bp[32 + 21] = t & 0xFF;
+      memcpy(bp, var->sha2_256_pk_seed.s, 32);
+      act |= 1u << k;
+      busy++;
+    }
+
+    if (c == nx && 2 * busy < lanes)
+    {
+      break;
+    }
+    sha2_256_compress_xl(vp, lanes, act);
+  }
+
+  /* remaining chains, each from its next step */
+  for (k = 0; k < lanes; k++)
+  {
+    if (lc[k] < nx)
+    {
+      bp = (uint8_t *)v[k];
+      adrs_set_chain_address(var, ci[lc[k]]);
+      sha2_256_chain(var, tmp + lc[k] * n, bp + 32 + 22, i[lc[k]] + lt[k],
+                     s[lc[k]] - lt[k]);
+    }
+  }
 }
 
-/* Combination WOTS PRF + Chain */
+#endif
 
-static void sha2_256_wots_chain(slh_var_t *var, uint8_t *tmp, uint32_t s)
+/* "nx" chains as in sha2_256_chain_xl(); one at a time if there are no */
+/* multi-lane kernels worth using. Scalar builds leave the lane buffers */
+/* out of this stack frame. */
+
+static void sha2_256_chain_x(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
+                             const uint32_t *ci, const uint32_t *i,
+                             const uint32_t *s, uint32_t nx)
 {
-  /* PRF secret key */
-  adrs_set_type(var, ADRS_WOTS_PRF);
-  adrs_set_tree_index(var, 0);
-  sha2_256_prf(var, tmp);
+  size_t n = var->prm->n;
+  uint32_t c;
+#ifdef PLAT_X64_SIMD
+  uint32_t lanes = sha2_256_lanes();
+
+  if (lanes > 1)
+  {
+    sha2_256_chain_xl(var, tmp, x, ci, i, s, nx, lanes);
+    return;
+  }
+#endif
+
+  for (c = 0; c < nx; c++)
+  {
+    adrs_set_chain_address(var, ci[c]);
+    sha2_256_chain(var, tmp + c * n, x + c * n, i[c], s[c]);
+  }
+}
+
+/* Multi-lane WOTS PRF + Chain: "nx" chains, key pair address kp[j], */
+/* chain address ci[j] and s[j] steps to "tmp" + j * n. Groups of chains */
+/* are hashed in lockstep; a finished lane keeps hashing a dummy value. */
+
+static void sha2_256_wots_chain_x(slh_var_t *var, uint8_t *tmp,
+                                  const uint32_t *kp, const uint32_t *ci,
+                                  const uint32_t *s, uint32_t nx)
+{
+  uint32_t v[16][(32 + 64) / 4];
+  void *vp[16];
+  uint8_t *bp;
+  size_t n = var->prm->n;
+  uint32_t lanes = sha2_256_lanes();
+  uint32_t j, k, l, t, s_max, act;
+
+  if (lanes == 1)
+  {
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_key_pair_address(var, kp[j]);
+      adrs_set_chain_address(var, ci[j]);
+      sha2_256_wots_chain(var, tmp + j * n, s[j]);
+    }
+    return;
+  }
+
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+
+    /* PRF secret keys; state || ADRSc || SK.seed || padding */
+    adrs_set_type(var, ADRS_WOTS_PRF);
+    adrs_set_tree_index(var, 0);
+    s_max = 0;
+    for (k = 0; k < lanes; k++)
+    {
+      bp = (uint8_t *)v[k];
+      vp[k] = bp;
+      if (k >= l)
+      {
+        memcpy(bp, v[0], sizeof(v[0])); /* unused lane */
+        continue;
+      }
+      adrs_set_key_pair_address(var, kp[j + k]);
+      adrs_set_chain_address(var, ci[j + k]);
+      memcpy(bp, var->sha2_256_pk_seed.s, 32);
+      adrsc_22(var, bp + 32);
+      memcpy(bp + 32 + 22, var->sk_seed, n);
+      memcpy(bp + 32 + 22 + n, (const uint8_t *)var->sha2_256_f_blk + 22 + n,
+             64 - 22 - n);
+      s_max = s[j + k] > s_max ? s[j + k] : s_max;
+    }
+
+    /* chain steps; the ADRSc type byte and hash address change */
+    act = (1u << l) - 1;
+    for (t = 0;; t++)
+    {
+      sha2_256_compress_xl(vp, lanes, act);
+
+      for (k = 0; k < l; k++)
+      {
+        bp = (uint8_t *)v[k];
+        if (t == s[j + k])
+        {
+          memcpy(tmp + (j + k) * n, bp, n); /* lane done */
+          act &= ~(1u << k);
+        }
+        bp[32 + 9] = ADRS_WOTS_HASH;
+        bp[32 + 18] = t >> 24;
+        bp[32 + 19] = (t >> 16) & 0xFF;
+        bp[32 + 20] = (t >> 8) & 0xFF;
+        bp[32 + 21] = t & 0xFF;
+        memcpy(bp + 32 + 22, bp, n);
+        memcpy(bp, var->sha2_256_pk_seed.s, 32);
+      }
+      if (t == s_max)
+      {
+        break;
+      }
+    }
+  }
 
-  /* chain */
   adrs_set_type(var, ADRS_WOTS_HASH);
   adrs_set_tree_index(var, 0);
-  sha2_256_chain(var, tmp, tmp, 0, s);
 }
 
 /* Combination FORS PRF + F (if s == 1) */
@@ -456,6 +922,93 @@ static void sha2_256_fors_hash(slh_var_t *var, uint8_t *tmp, uint32_t s)
   }
 }
 
+/* Multi-lane FORS PRF + F (if s == 1): "nx" leaves with tree indices */
+/* counting up from the one in ADRS, to "tmp" + j * n. If "sk" is not */
+/* NULL, the PRF output (secret value) of leaf "si" is also copied there. */
+
+static void sha2_256_fors_hash_x(slh_var_t *var, uint8_t *tmp, uint32_t s,
+                                 uint32_t nx, uint8_t *sk, uint32_t si)
+{
+  uint32_t v[16][(32 + 64) / 4];
+  void *vp[16];
+  uint8_t *bp;
+  size_t n = var->prm->n;
+  uint32_t lanes = sha2_256_lanes();
+  uint32_t j, k, l, ti;
+
+  ti = adrs_get_tree_index(var);
+  if (lanes == 1)
+  {
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_tree_index(var, ti + j);
+      if (sk == NULL || j != si)
+      {
+        sha2_256_fors_hash(var, tmp + j * n, s);
+        continue;
+      }
+      sha2_256_fors_hash(var, sk, 0);
+      memcpy(tmp + j * n, sk, n);
+      if (s == 1)
+      {
+        adrs_set_type(var, ADRS_FORS_TREE);
+        sha2_256_f(var, tmp + j * n, tmp + j * n);
+      }
+    }
+    adrs_set_tree_index(var, ti);
+    return;
+  }
+
+  adrs_set_type(var, ADRS_FORS_PRF);
+  adrs_set_tree_height(var, 0);
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+
+    /* PRF secret keys; state || ADRSc || SK.seed || padding */
+    for (k = 0; k < lanes; k++)
+    {
+      bp = (uint8_t *)v[k];
+      vp[k] = bp;
+      adrs_set_tree_index(var, ti + j + (k < l ? k : 0));
+      memcpy(bp, var->sha2_256_pk_seed.s, 32);
+      adrsc_22(var, bp + 32);
+      memcpy(bp + 32 + 22, var->sk_seed, n);
+      memcpy(bp + 32 + 22 + n, (const uint8_t *)var->sha2_256_f_blk + 22 + n,
+             64 - 22 - n);
+    }
+    sha2_256_compress_xl(vp, lanes, (1u << l) - 1);
+    if (sk != NULL && si - j < l)
+    {
+      memcpy(sk, v[si - j], n);
+    }
+
+    /* hash it again; only the ADRSc type byte changes */
+    if (s == 1)
+    {
+      for (k = 0; k < lanes; k++)
+      {
+        bp = (uint8_t *)v[k];
+        bp[32 + 9] = ADRS_FORS_TREE;
+        memcpy(bp + 32 + 22, bp, n);
+        memcpy(bp, var->sha2_256_pk_seed.s, 32);
+      }
+      sha2_256_compress_xl(vp, lanes, (1u << l) - 1);
+    }
+
+    for (k = 0; k < l; k++)
+    {
+      memcpy(tmp + (j + k) * n, v[k], n);
+    }
+  }
+
+  if (s == 1)
+  {
+    adrs_set_type(var, ADRS_FORS_TREE);
+  }
+  adrs_set_tree_index(var, ti);
+}
+
 /* 10.2.   SLH-DSA Using SHA2 for Security Category 1 */
 
 const slh_param_t slh_dsa_sha2_128s = {/* .alg_id = */ "SLH-DSA-SHA2-128s",
@@ -467,16 +1020,36 @@ const slh_param_t slh_dsa_sha2_128s = {/* .alg_id = */ "SLH-DSA-SHA2-128s",
                                        /* .k = */ 14,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 30,
+                                       /* .len1 = */ 32,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 35,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 704,
+                                       /* .fors_sz = */ 2912,
+                                       /* .sig_sz = */ 7856,
+                                       /* .md_sz = */ 21,
+                                       /* .tree_sz = */ 7,
+                                       /* .leaf_sz = */ 2,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 10,
+                                       /* .leaf_mask = */ (1 << 9) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_256_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_256_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_256_h,
-                                       /* .h_t = */ sha2_256_tl};
+                                       /* .h_h_x = */ sha2_256_h_x,
+                                       /* .h_t = */ sha2_256_tl,
+                                       /* .h_t_x = */ sha2_256_tl_x};
 
 const slh_param_t slh_dsa_sha2_128f = {/* .alg_id = */ "SLH-DSA-SHA2-128f",
                                        /* .n = */ 16,
@@ -487,16 +1060,36 @@ const slh_param_t slh_dsa_sha2_128f = {/* .alg_id = */ "SLH-DSA-SHA2-128f",
                                        /* .k = */ 33,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 34,
+                                       /* .len1 = */ 32,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 35,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 608,
+                                       /* .fors_sz = */ 3696,
+                                       /* .sig_sz = */ 17088,
+                                       /* .md_sz = */ 25,
+                                       /* .tree_sz = */ 8,
+                                       /* .leaf_sz = */ 1,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 1,
+                                       /* .leaf_mask = */ (1 << 3) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_256_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_256_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_256_h,
-                                       /* .h_t = */ sha2_256_tl};
+                                       /* .h_h_x = */ sha2_256_h_x,
+                                       /* .h_t = */ sha2_256_tl,
+                                       /* .h_t_x = */ sha2_256_tl_x};
 
 /* 10.3.   SLH-DSA Using SHA2 for Security Categories 3 and 5 */
 
@@ -509,16 +1102,36 @@ const slh_param_t slh_dsa_sha2_192s = {/* .alg_id = */ "SLH-DSA-SHA2-192s",
                                        /* .k = */ 17,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 39,
+                                       /* .len1 = */ 48,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 51,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 1440,
+                                       /* .fors_sz = */ 6120,
+                                       /* .sig_sz = */ 16224,
+                                       /* .md_sz = */ 30,
+                                       /* .tree_sz = */ 7,
+                                       /* .leaf_sz = */ 2,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 10,
+                                       /* .leaf_mask = */ (1 << 9) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_512_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_512_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_512_h,
-                                       /* .h_t = */ sha2_512_tl};
+                                       /* .h_h_x = */ sha2_512_h_x,
+                                       /* .h_t = */ sha2_512_tl,
+                                       /* .h_t_x = */ sha2_512_tl_x};
 
 const slh_param_t slh_dsa_sha2_192f = {/* .alg_id = */ "SLH-DSA-SHA2-192f",
                                        /* .n = */ 24,
@@ -529,16 +1142,36 @@ const slh_param_t slh_dsa_sha2_192f = {/* .alg_id = */ "SLH-DSA-SHA2-192f",
                                        /* .k = */ 33,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 42,
+                                       /* .len1 = */ 48,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 51,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 1296,
+                                       /* .fors_sz = */ 7128,
+                                       /* .sig_sz = */ 35664,
+                                       /* .md_sz = */ 33,
+                                       /* .tree_sz = */ 8,
+                                       /* .leaf_sz = */ 1,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 1,
+                                       /* .leaf_mask = */ (1 << 3) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_512_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_512_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_512_h,
-                                       /* .h_t = */ sha2_512_tl};
+                                       /* .h_h_x = */ sha2_512_h_x,
+                                       /* .h_t = */ sha2_512_tl,
+                                       /* .h_t_x = */ sha2_512_tl_x};
 
 const slh_param_t slh_dsa_sha2_256s = {/* .alg_id = */ "SLH-DSA-SHA2-256s",
                                        /* .n = */ 32,
@@ -549,16 +1182,36 @@ const slh_param_t slh_dsa_sha2_256s = {/* .alg_id = */ "SLH-DSA-SHA2-256s",
                                        /* .k = */ 22,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 47,
+                                       /* .len1 = */ 64,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 67,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 2400,
+                                       /* .fors_sz = */ 10560,
+                                       /* .sig_sz = */ 29792,
+                                       /* .md_sz = */ 39,
+                                       /* .tree_sz = */ 7,
+                                       /* .leaf_sz = */ 1,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 8,
+                                       /* .leaf_mask = */ (1 << 8) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_512_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_512_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_512_h,
-                                       /* .h_t = */ sha2_512_tl};
+                                       /* .h_h_x = */ sha2_512_h_x,
+                                       /* .h_t = */ sha2_512_tl,
+                                       /* .h_t_x = */ sha2_512_tl_x};
 
 const slh_param_t slh_dsa_sha2_256f = {/* .alg_id = */ "SLH-DSA-SHA2-256f",
                                        /* .n = */ 32,
@@ -569,13 +1222,39 @@ const slh_param_t slh_dsa_sha2_256f = {/* .alg_id = */ "SLH-DSA-SHA2-256f",
                                        /* .k = */ 35,
                                        /* .lg_w = */ 4,
                                        /* .m = */ 49,
+                                       /* .len1 = */ 64,
+                                       /* .len2 = */ 3,
+                                       /* .len = */ 67,
+                                       /* .csum_shl = */ 4,
+                                       /* .csum_sz = */ 2,
+                                       /* .xmss_sz = */ 2272,
+                                       /* .fors_sz = */ 11200,
+                                       /* .sig_sz = */ 49856,
+                                       /* .md_sz = */ 40,
+                                       /* .tree_sz = */ 8,
+                                       /* .leaf_sz = */ 1,
+                                       /* .tree_mask = */ ~UINT64_C(0) >> 0,
+                                       /* .leaf_mask = */ (1 << 4) - 1,
                                        /* .mk_var = */ sha2_mk_var,
                                        /* .chain = */ sha2_256_chain,
+                                       /* .chain_x = */ sha2_256_chain_x,
                                        /* .wots_chain = */ sha2_256_wots_chain,
+                                       /* .wots_chain_x = */
+                                       sha2_256_wots_chain_x,
                                        /* .fors_hash = */ sha2_256_fors_hash,
+                                       /* .fors_hash_x = */
+                                       sha2_256_fors_hash_x,
                                        /* .h_msg = */ sha2_512_h_msg,
                                        /* .prf = */ sha2_256_prf,
                                        /* .prf_msg = */ sha2_512_prf_msg,
                                        /* .h_f = */ sha2_256_f,
                                        /* .h_h = */ sha2_512_h,
-                                       /* .h_t = */ sha2_512_tl};
+                                       /* .h_h_x = */ sha2_512_h_x,
+                                       /* .h_t = */ sha2_512_tl,
+                                       /* .h_t_x = */ sha2_512_tl_x};
+
+#else /* SLH_FIXED_PARAM && !SLH_FIXED_UNIT */
+
+SLH_EMPTY_CU(slh_sha2)
+
+#endif /* SLH_FIXED_PARAM */
@@ -9,6 +9,9 @@
 #include "slh_adrs.h"
 #include "slh_var.h"
 
+/* with SLH_FIXED_PARAM, this file is compiled as a part of slh_dsa.c */
+#if !defined(SLH_FIXED_PARAM) || defined(SLH_FIXED_UNIT)
+
 /* === 10.1.   SLH-DSA Using SHAKE */
 
 /* Hmsg(R, PK.seed, PK.root, M) = SHAKE256(R || PK.seed || PK.root || M, */
@@ -40,19 +43,143 @@ static void shake_h_msg(slh_var_t *var, uint8_t *h, const uint8_t *r,
   shake_out(&sha3, h, var->prm->m);
 }
 
-/* F(PK.seed, ADRS, M1 ) = SHAKE256(PK.seed || ADRS || M1, 8n) */
+/* Single-state functions keep the state in the form the permutation */
+/* takes: 64-bit lanes, or on 32-bit targets the bit-interleaved words */
+/* of keccak_f1600_bi32(), so that only the lanes that change between */
+/* permutations are converted. Lane i is the SHAKE_LW words at */
+/* SHAKE_LW * i; the first n bytes of a state are n / 8 lanes in both. */
 
-static void shake_f(slh_var_t *var, uint8_t *h, const uint8_t *m1)
+#if PLAT_XLEN == 32
+
+#define SHAKE_LW 2 /* words per lane */
+typedef uint32_t shake_st_t;
+
+static void shake_setl(shake_st_t *s, size_t i, uint64_t v)
+{
+  uint32_t lo = unzip32((uint32_t)v);
+  uint32_t hi = unzip32((uint32_t)(v >> 32));
+
+  s[2 * i] = (lo & 0x0000FFFF) | (hi << 16);
+  s[2 * i + 1] = (lo >> 16) | (hi & 0xFFFF0000);
+}
+
+static void shake_xorl(shake_st_t *s, size_t i, uint64_t v)
+{
+  uint32_t lo = unzip32((uint32_t)v);
+  uint32_t hi = unzip32((uint32_t)(v >> 32));
+
+  s[2 * i] ^= (lo & 0x0000FFFF) | (hi << 16);
+  s[2 * i + 1] ^= (lo >> 16) | (hi & 0xFFFF0000);
+}
+
+static uint64_t shake_getl(const shake_st_t *s, size_t i)
+{
+  uint32_t lo = zip32((s[2 * i] & 0x0000FFFF) | (s[2 * i + 1] << 16));
+  uint32_t hi = zip32((s[2 * i] >> 16) | (s[2 * i + 1] & 0xFFFF0000));
+
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void shake_perm(shake_st_t *s) { keccak_f1600_bi32(s); }
+
+#else
+
+#define SHAKE_LW 1 /* words per lane */
+typedef uint64_t shake_st_t;
+
+static void shake_setl(shake_st_t *s, size_t i, uint64_t v) { s[i] = v; }
+
+static void shake_xorl(shake_st_t *s, size_t i, uint64_t v) { s[i] ^= v; }
+
+static uint64_t shake_getl(const shake_st_t *s, size_t i) { return s[i]; }
+
+static void shake_perm(shake_st_t *s) { keccak_f1600(s); }
+
+#endif
+
+/* set lanes from "i" on to "sz" bytes at "x"; sz is a multiple of 8 */
+
+static void shake_setb(shake_st_t *s, size_t i, const void *x, size_t sz)
+{
+  uint64_t t;
+  size_t j;
+
+  for (j = 0; j < sz; j += 8)
+  {
+    memcpy(&t, (const uint8_t *)x + j, 8);
+    shake_setl(s, i + j / 8, t);
+  }
+}
+
+/* get the first "sz" bytes of the state */
+
+static void shake_getb(void *x, const shake_st_t *s, size_t sz)
+{
+  uint64_t t;
+  size_t j;
+
+  for (j = 0; j < sz; j += 8)
+  {
+    t = shake_getl(s, j / 8);
+    memcpy((uint8_t *)x + j, &t, 8);
+  }
+}
+
+/* single-block state: PK.seed || ADRS || (m_sz bytes) || padding */
+
+static void shake_tpl(slh_var_t *var, shake_st_t *ks, size_t m_sz)
 {
-  sha3_var_t sha3;
   size_t n = var->prm->n;
+  const uint32_t r = (1600 - 256 * 2) / 64; /* SHAKE256 rate */
+  uint32_t l = (n + 32 + m_sz) / 8;         /* input length */
 
-  shake256_init(&sha3);
-  shake_update(&sha3, var->pk_seed, n);
-  shake_update(&sha3, (const uint8_t *)var->adrs->u8, 32);
-  shake_update(&sha3, m1, n);
+  memset(ks, 0, 25 * SHAKE_LW * sizeof(shake_st_t));
+  shake_setb(ks, 0, var->pk_seed, n);                        /* PK.seed */
+  shake_setb(ks, n / 8, (const uint8_t *)var->adrs->u8, 32); /* address */
 
-  shake_out(&sha3, h, n);
+  /* padding */
+  shake_xorl(ks, l, 0x1F);                  /* shake padding */
+  shake_xorl(ks, r - 1, UINT64_C(1) << 63); /* rate padding */
+}
+
+/* the same in 64-bit lanes, for the multi-lane functions */
+
+#if PLAT_XLEN == 32
+static void shake_tpl_x(slh_var_t *var, uint64_t ks[25], size_t m_sz)
+{
+  uint32_t w[50];
+
+  shake_tpl(var, w, m_sz);
+  keccak_bi32_out(ks, w);
+}
+#else
+#define shake_tpl_x shake_tpl
+#endif
+
+/* F, H, PRF: one permutation of PK.seed || ADRS || m1 (|| m2) */
+
+static void shake_blk(slh_var_t *var, uint8_t *h, const uint8_t *m1,
+                      const uint8_t *m2)
+{
+  shake_st_t ks[25 * SHAKE_LW];
+  size_t n = var->prm->n;
+  uint32_t i = n / 8 + (32 / 8); /* message offset in lanes */
+
+  shake_tpl(var, ks, m2 == NULL ? n : 2 * n);
+  shake_setb(ks, i, m1, n);
+  if (m2 != NULL)
+  {
+    shake_setb(ks, i + n / 8, m2, n);
+  }
+  shake_perm(ks);
+  shake_getb(h, ks, n);
+}
+
+/* F(PK.seed, ADRS, M1 ) = SHAKE256(PK.seed || ADRS || M1, 8n) */
+
+static void shake_f(slh_var_t *var, uint8_t *h, const uint8_t *m1)
+{
+  shake_blk(var, h, m1, NULL);
 }
 
 /* PRF(PK.seed, SK.seed, ADRS) = SHAKE256(PK.seed || ADRS || SK.seed, 8n) */
@@ -94,15 +221,135 @@ static void shake_prf_msg(slh_var_t *var, uint8_t *h, const uint8_t *opt_rand,
 
 static void shake_t(slh_var_t *var, uint8_t *h, const uint8_t *m, size_t m_sz)
 {
-  sha3_var_t sha3;
+  shake_st_t ks[25 * SHAKE_LW];
+  uint64_t t;
   size_t n = var->prm->n;
+  const uint32_t r = (1600 - 256 * 2) / 64; /* SHAKE256 rate */
+  uint32_t i = n / 8 + (32 / 8);            /* PK.seed || ADRS lanes */
+  size_t l = m_sz / 8;                      /* m_sz is a multiple of n */
 
-  shake256_init(&sha3);
-  shake_update(&sha3, var->pk_seed, n);
-  shake_update(&sha3, (const uint8_t *)var->adrs->u8, 32);
-  shake_update(&sha3, m, m_sz);
+  memset(ks, 0, sizeof(ks));
+  shake_setb(ks, 0, var->pk_seed, n);
+  shake_setb(ks, n / 8, (const uint8_t *)var->adrs->u8, 32);
 
-  shake_out(&sha3, h, n);
+  /* absorb whole words */
+  while (l > 0)
+  {
+    while (i < r && l > 0)
+    {
+      memcpy(&t, m, 8);
+      shake_xorl(ks, i++, t);
+      m += 8;
+      l--;
+    }
+    if (i == r)
+    {
+      shake_perm(ks);
+      i = 0;
+    }
+  }
+
+  shake_xorl(ks, i, 0x1F);                  /* shake padding */
+  shake_xorl(ks, r - 1, UINT64_C(1) << 63); /* rate padding */
+  shake_perm(ks);
+  shake_getb(h, ks, n);
+}
+
+/* "lanes" (8 or 4, see keccak_f1600_lanes()) interleaved permutations; */
+/* only those in the bit mask "act" are used */
+
+static void keccak_f1600_xl(uint64_t kx[8 * 25], uint32_t lanes, uint32_t act)
+{
+  if (lanes == 8)
+  {
+    keccak_f1600_x8(kx, act);
+  }
+  else
+  {
+    keccak_f1600_x4(kx, act);
+  }
+}
+
+/* Multi-lane T_l: "nx" messages of "m_sz" bytes at "m" + j * m_sz, with */
+/* key pair addresses counting up from the one in ADRS, to "h" + j * n. */
+/* The states are absorbed in lockstep; lanes beyond "nx" repeat the first. */
+
+static void shake_t_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                      size_t m_sz, uint32_t nx)
+{
+  uint64_t kx[8 * 25], hd[8][(32 + 32) / 8], t;
+  size_t n = var->prm->n;
+  const uint32_t r = (1600 - 256 * 2) / 64; /* SHAKE256 rate */
+  uint32_t hl = n / 8 + (32 / 8);           /* PK.seed || ADRS words */
+  size_t l = hl + m_sz / 8;                 /* m_sz is a multiple of n */
+  uint32_t lanes = keccak_f1600_lanes();
+  uint32_t i, j, k, c, kp;
+  size_t g;
+
+  kp = adrs_get_key_pair_address(var);
+  if (lanes == 1)
+  {
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_key_pair_address(var, kp + j);
+      shake_t(var, h + j * n, m + j * m_sz, m_sz);
+    }
+    adrs_set_key_pair_address(var, kp);
+    return;
+  }
+
+  for (j = 0; j < nx; j += c)
+  {
+    c = nx - j < lanes ? nx - j : lanes;
+    for (k = 0; k < c; k++)
+    {
+      adrs_set_key_pair_address(var, kp + j + k);
+      memcpy(hd[k], var->pk_seed, n);
+      memcpy(hd[k] + n / 8, (const uint8_t *)var->adrs->u8, 32);
+    }
+
+    /* lane i of state k is in kx[lanes * i + k]; "g" is the word offset */
+    memset(kx, 0, sizeof(kx));
+    for (g = 0; g <= l; g += r)
+    {
+      for (k = 0; k < lanes; k++)
+      {
+        const uint8_t *mk = m + (j + (k < c ? k : 0)) * m_sz;
+        const uint64_t *hk = hd[k < c ? k : 0];
+
+        for (i = 0; i < r; i++)
+        {
+          if (g + i < hl)
+          {
+            t = hk[g + i];
+          }
+          else if (g + i < l)
+          {
+            memcpy(&t, mk + (g + i - hl) * 8, 8);
+          }
+          else
+          {
+            t = g + i == l ? 0x1F : 0; /* shake padding */
+          }
+          if (i == r - 1 && g + r > l)
+          {
+            t ^= UINT64_C(1) << 63; /* rate padding */
+          }
+          kx[lanes * i + k] ^= t;
+        }
+      }
+      keccak_f1600_xl(kx, lanes, (1u << c) - 1);
+    }
+
+    for (k = 0; k < c; k++)
+    {
+      for (i = 0; i < n / 8; i++)
+      {
+        memcpy(h + (j + k) * n + 8 * i, &kx[lanes * i + k], 8);
+      }
+    }
+  }
+  adrs_set_key_pair_address(var, kp);
 }
 
 /* H(PK.seed, ADRS, M2 ) = SHAKE256(PK.seed || ADRS || M2, 8n) */
@@ -110,16 +357,55 @@ static void shake_t(slh_var_t *var, uint8_t *h, const uint8_t *m, size_t m_sz)
 static void shake_h(slh_var_t *var, uint8_t *h, const uint8_t *m1,
                     const uint8_t *m2)
 {
-  sha3_var_t sha3;
+  shake_blk(var, h, m1, m2);
+}
+
+/* Multi-lane H: "nx" node pairs at "m" + 2 * j * n, with tree indices */
+/* counting up from the one in ADRS, to "h" + j * n ("h" may be "m"). */
+
+static void shake_h_x(slh_var_t *var, uint8_t *h, const uint8_t *m,
+                      uint32_t nx)
+{
+  uint64_t kt[25], kx[8 * 25];
   size_t n = var->prm->n;
+  uint32_t n8 = n / 8;
+  uint32_t lanes = keccak_f1600_lanes();
+  uint32_t i, j, k, l, c, ti;
 
-  shake256_init(&sha3);
-  shake_update(&sha3, var->pk_seed, n);
-  shake_update(&sha3, (const uint8_t *)var->adrs->u8, 32);
-  shake_update(&sha3, m1, n);
-  shake_update(&sha3, m2, n);
+  ti = adrs_get_tree_index(var);
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+    if (l < 2)
+    {
+      adrs_set_tree_index(var, ti + j);
+      shake_blk(var, h + j * n, m + 2 * j * n, m + (2 * j + 1) * n);
+      continue;
+    }
 
-  shake_out(&sha3, h, n);
+    /* all inputs of the group are read before any output is written */
+    for (k = 0; k < lanes; k++)
+    {
+      c = k < l ? j + k : j;
+      adrs_set_tree_index(var, ti + c);
+      shake_tpl_x(var, kt, 2 * n);
+      memcpy(kt + n8 + (32 / 8), m + 2 * c * n, 2 * n);
+      for (i = 0; i < 25; i++)
+      {
+        kx[lanes * i + k] = kt[i];
+      }
+    }
+    keccak_f1600_xl(kx, lanes, (1u << l) - 1);
+
+    for (k = 0; k < l; k++)
+    {
+      for (i = 0; i < n8; i++)
+      {
+        memcpy(h + (j + k) * n + 8 * i, &kx[lanes * i + k], 8);
+      }
+    }
+  }
+  adrs_set_tree_index(var, ti);
 }
 
 /* create a context */
@@ -152,16 +438,33 @@ static void shake_mk_var(slh_var_t *var, const uint8_t *pk, const uint8_t *sk,
 
 /* chaining by processor (some optimizations) */
 
+/* "s" chain steps from "ks" (first n bytes); per step, only the */
+/* hash address and the chaining value of the template "kt" change */
+
+static void shake_chain_steps(slh_var_t *var, shake_st_t *ks,
+                              shake_st_t *kt, uint32_t i, uint32_t s)
+{
+  uint32_t j;
+  size_t n = var->prm->n;
+  uint32_t n8 = n / 8;        /* number of lanes */
+  uint32_t h = n8 + (32 / 8); /* static part len */
+
+  for (j = 0; j < s; j++)
+  {
+    memcpy(kt + SHAKE_LW * h, ks, n);  /* chaining */
+    adrs_set_hash_address(var, i + j); /* address */
+    shake_setb(kt, n8 + 3, (const uint8_t *)var->adrs->u8 + 24, 8);
+
+    memcpy(ks, kt, 25 * SHAKE_LW * sizeof(shake_st_t));
+    shake_perm(ks); /* permutation */
+  }
+}
+
 static void shake_chain(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
                         uint32_t i, uint32_t s)
 {
-  uint32_t j, k;
-  uint64_t ks[25];
+  shake_st_t ks[25 * SHAKE_LW], kt[25 * SHAKE_LW];
   size_t n = var->prm->n;
-  const uint32_t r = (1600 - 256 * 2) / 64; /* SHAKE256 rate */
-  uint32_t n8 = n / 8;                      /* number of words */
-  uint32_t h = n8 + (32 / 8);               /* static part len */
-  uint32_t l = h + n8;                      /* input length */
 
   if (s == 0)
   { /* no-op */
@@ -169,46 +472,251 @@ static void shake_chain(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
     return;
   }
 
-  memcpy(ks + h, x, n); /* start node */
-  for (j = 0; j < s; j++)
+  shake_tpl(var, kt, n);
+  shake_setb(ks, 0, x, n); /* start node */
+  shake_chain_steps(var, ks, kt, i, s);
+  shake_getb(tmp, ks, n);
+}
+
+/* Combination WOTS PRF + Chain */
+
+static void shake_wots_chain(slh_var_t *var, uint8_t *tmp, uint32_t s)
+{
+  shake_st_t ks[25 * SHAKE_LW], kt[25 * SHAKE_LW];
+  size_t n = var->prm->n;
+
+  /* PRF secret key, in the same state layout as the chain */
+  adrs_set_type(var, ADRS_WOTS_PRF);
+  adrs_set_tree_index(var, 0);
+  shake_tpl(var, kt, n);
+  shake_setb(kt, n / 8 + (32 / 8), var->sk_seed, n);
+  memcpy(ks, kt, 25 * SHAKE_LW * sizeof(shake_st_t));
+  shake_perm(ks);
+
+  /* chain; only the type lane of the template changes */
+  adrs_set_type(var, ADRS_WOTS_HASH);
+  shake_setb(kt, n / 8 + 2, (const uint8_t *)var->adrs->u8 + 16, 8);
+  shake_chain_steps(var, ks, kt, 0, s);
+  shake_getb(tmp, ks, n);
+}
+
+#ifdef PLAT_X64_SIMD
+
+/* Multi-lane chain over "lanes" (8 or 4) lanes: "nx" chains of the key */
+/* pair in ADRS, chain address ci[j], from "x" + j * n at step i[j] for */
+/* s[j] steps to "tmp" + j * n. */
+/* A lane that finishes its chain is refilled with the next one; the */
+/* last chain to run alone is completed with single permutations. */
+
+static void shake_chain_xl(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
+                           const uint32_t *ci, const uint32_t *i,
+                           const uint32_t *s, uint32_t nx, uint32_t lanes)
+{
+  uint64_t kt[8][25], kx[8 * 25];
+  uint32_t lc[8], lt[8]; /* chain in lane, steps done */
+  size_t n = var->prm->n;
+  uint32_t n8 = n / 8;
+  uint32_t c, j, k, busy, act;
+
+  memset(kt, 0x00, sizeof(kt));
+  for (k = 0; k < lanes; k++)
   {
-    if (j > 0)
+    lc[k] = nx; /* idle */
+  }
+
+  c = 0;
+  while (1)
+  {
+    busy = 0;
+    act = 0;
+    for (k = 0; k < lanes; k++)
     {
-      memcpy(ks + h, ks, n); /* chaining */
+      if (lc[k] < nx)
+      {
+        for (j = 0; j < n8; j++)
+        {
+          kt[k][n8 + (32 / 8) + j] = kx[lanes * j + k]; /* chaining */
+        }
+        if (++lt[k] == s[lc[k]])
+        {
+          memcpy(tmp + lc[k] * n, kt[k] + n8 + (32 / 8), n); /* done */
+          lc[k] = nx;
+        }
+      }
+      if (lc[k] < nx)
+      {
+        /* next step; only the hash address word changes */
+        adrs_set_chain_address(var, ci[lc[k]]);
+        adrs_set_hash_address(var, i[lc[k]] + lt[k]);
+        memcpy(kt[k] + n8 + 3, (const uint8_t *)var->adrs->u8 + 24, 8);
+      }
+      else
+      {
+        /* refill; zero-step chains are copies */
+        while (c < nx && s[c] == 0)
+        {
+          memcpy(tmp + c * n, x + c * n, n);
+          c++;
+        }
+        if (c == nx)
+        {
+          continue;
+        }
+        lc[k] = c;
+        lt[k] = 0;
+        adrs_set_chain_address(var, ci[c]);
+        adrs_set_hash_address(var, i[c]);
+        shake_tpl_x(var, kt[k], n);
+        memcpy(kt[k] + n8 + (32 / 8), x + c * n, n);
+        c++;
+      }
+      act |= 1u << k;
+      busy++;
     }
-    memcpy(ks, var->pk_seed, n);       /* PK.seed */
-    adrs_set_hash_address(var, i + j); /* address */
-    memcpy(ks + n8, (const uint8_t *)var->adrs->u8, 32);
 
-    /* padding */
-    ks[l] = 0x1F; /* shake padding */
-    for (k = l + 1; k < r - 1; k++)
+    if (c == nx && busy < 2)
     {
-      ks[k] = 0;
+      break;
     }
-    ks[r - 1] = UINT64_C(1) << 63; /* rate padding */
-    for (k = r; k < 25; k++)
+
+    /* lane j of state k is in kx[lanes * j + k] */
+    for (k = 0; k < lanes; k++)
     {
-      ks[k] = 0;
+      for (j = 0; j < 25; j++)
+      {
+        kx[lanes * j + k] = kt[k][j];
+      }
     }
+    keccak_f1600_xl(kx, lanes, act);
+  }
 
-    keccak_f1600(ks); /* permutation */
+  /* remaining chain, from its next step */
+  for (k = 0; k < lanes; k++)
+  {
+    if (lc[k] < nx)
+    {
+      j = lc[k];
+      adrs_set_chain_address(var, ci[j]);
+      shake_chain(var, tmp + j * n, (const uint8_t *)(kt[k] + n8 + (32 / 8)),
+                  i[j] + lt[k], s[j] - lt[k]);
+    }
   }
-  memcpy(tmp, ks, n);
 }
 
-/* Combination WOTS PRF + Chain */
+#endif
 
-static void shake_wots_chain(slh_var_t *var, uint8_t *tmp, uint32_t s)
+/* "nx" chains as in shake_chain_xl(); one at a time if there are no */
+/* multi-lane kernels worth using. Scalar builds leave the lane buffers */
+/* out of this stack frame. */
+
+static void shake_chain_x(slh_var_t *var, uint8_t *tmp, const uint8_t *x,
+                          const uint32_t *ci, const uint32_t *i,
+                          const uint32_t *s, uint32_t nx)
 {
-  /* PRF secret key */
-  adrs_set_type(var, ADRS_WOTS_PRF);
-  adrs_set_tree_index(var, 0);
-  shake_prf(var, tmp);
+  size_t n = var->prm->n;
+  uint32_t c;
+#ifdef PLAT_X64_SIMD
+  uint32_t lanes = keccak_f1600_lanes();
 
-  /* chain */
-  adrs_set_type(var, ADRS_WOTS_HASH);
-  shake_chain(var, tmp, tmp, 0, s);
+  if (lanes > 1)
+  {
+    shake_chain_xl(var, tmp, x, ci, i, s, nx, lanes);
+    return;
+  }
+#endif
+
+  for (c = 0; c < nx; c++)
+  {
+    adrs_set_chain_address(var, ci[c]);
+    shake_chain(var, tmp + c * n, x + c * n, i[c], s[c]);
+  }
+}
+
+/* Multi-lane WOTS PRF + Chain: "nx" chains, key pair address kp[j], */
+/* chain address ci[j] and s[j] steps to "tmp" + j * n. Groups of chains */
+/* are permuted in lockstep; a finished lane keeps permuting a dummy. */
+
+static void shake_wots_chain_x(slh_var_t *var, uint8_t *tmp,
+                               const uint32_t *kp, const uint32_t *ci,
+                               const uint32_t *s, uint32_t nx)
+{
+  uint64_t kt[8][25], kx[8 * 25];
+  size_t n = var->prm->n;
+  uint32_t n8 = n / 8;
+  uint32_t lanes = keccak_f1600_lanes();
+  uint32_t i, j, k, l, t, s_max, act;
+
+  if (lanes == 1)
+  {
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_key_pair_address(var, kp[j]);
+      adrs_set_chain_address(var, ci[j]);
+      shake_wots_chain(var, tmp + j * n, s[j]);
+    }
+    return;
+  }
+
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+
+    /* PRF secret keys, in the same state layout as the chain */
+    adrs_set_type(var, ADRS_WOTS_PRF);
+    adrs_set_tree_index(var, 0);
+    s_max = 0;
+    for (k = 0; k < l; k++)
+    {
+      adrs_set_key_pair_address(var, kp[j + k]);
+      adrs_set_chain_address(var, ci[j + k]);
+      shake_tpl_x(var, kt[k], n);
+      memcpy(kt[k] + n8 + (32 / 8), var->sk_seed, n);
+      s_max = s[j + k] > s_max ? s[j + k] : s_max;
+    }
+    for (; k < lanes; k++)
+    {
+      memcpy(kt[k], kt[0], sizeof(kt[0])); /* unused lane */
+    }
+    adrs_set_type(var, ADRS_WOTS_HASH);
+
+    /* lane i of state k is in kx[lanes * i + k] */
+    act = (1u << l) - 1;
+    for (t = 0;; t++)
+    {
+      for (k = 0; k < lanes; k++)
+      {
+        for (i = 0; i < 25; i++)
+        {
+          kx[lanes * i + k] = kt[k][i];
+        }
+      }
+      keccak_f1600_xl(kx, lanes, act);
+
+      /* chaining; only the type and hash address words change */
+      for (k = 0; k < l; k++)
+      {
+        for (i = 0; i < n8; i++)
+        {
+          kt[k][n8 + (32 / 8) + i] = kx[lanes * i + k];
+        }
+        if (t == s[j + k])
+        {
+          memcpy(tmp + (j + k) * n, kt[k] + n8 + (32 / 8), n); /* done */
+          act &= ~(1u << k);
+        }
+        adrs_set_key_pair_address(var, kp[j + k]);
+        adrs_set_chain_address(var, ci[j + k]);
+        adrs_set_hash_address(var, t);
+        memcpy(kt[k] + n8 + 2, (const uint8_t *)var->adrs->u8 + 16, 16);
+      }
+      if (t == s_max)
+      {
+        break;
+      }
+    }
+  }
+
+  adrs_set_tree_index(var, 0);
 }
 
 /* Combination FORS PRF + F (if s == 1) */
@@ -228,6 +736,92 @@ static void shake_fors_hash(slh_var_t *var, uint8_t *tmp, uint32_t s)
   }
 }
 
+/* Multi-lane FORS PRF + F (if s == 1): "nx" leaves with tree indices */
+/* counting up from the one in ADRS, to "tmp" + j * n. If "sk" is not */
+/* NULL, the PRF output (secret value) of leaf "si" is also copied there. */
+
+static void shake_fors_hash_x(slh_var_t *var, uint8_t *tmp, uint32_t s,
+                              uint32_t nx, uint8_t *sk, uint32_t si)
+{
+  uint64_t kt[8][25], kx[8 * 25];
+  size_t n = var->prm->n;
+  uint32_t n8 = n / 8;
+  uint32_t lanes = keccak_f1600_lanes();
+  uint32_t i, j, k, l, t, ti;
+
+  ti = adrs_get_tree_index(var);
+  if (lanes == 1)
+  {
+    for (j = 0; j < nx; j++)
+    {
+      adrs_set_tree_index(var, ti + j);
+      if (sk == NULL || j != si)
+      {
+        shake_fors_hash(var, tmp + j * n, s);
+        continue;
+      }
+      shake_fors_hash(var, sk, 0);
+      memcpy(tmp + j * n, sk, n);
+      if (s == 1)
+      {
+        adrs_set_type(var, ADRS_FORS_TREE);
+        shake_f(var, tmp + j * n, tmp + j * n);
+      }
+    }
+    adrs_set_tree_index(var, ti);
+    return;
+  }
+
+  adrs_set_tree_height(var, 0);
+  for (j = 0; j < nx; j += l)
+  {
+    l = nx - j < lanes ? nx - j : lanes;
+
+    /* PRF secret key, then F; only the type word changes */
+    for (t = 0; t <= s; t++)
+    {
+      adrs_set_type(var, t == 0 ? ADRS_FORS_PRF : ADRS_FORS_TREE);
+      for (k = 0; k < lanes; k++)
+      {
+        adrs_set_tree_index(var, ti + j + (k < l ? k : 0));
+        shake_tpl_x(var, kt[k], n);
+        if (t == 0)
+        {
+          memcpy(kt[k] + n8 + (32 / 8), var->sk_seed, n);
+        }
+        else
+        {
+          for (i = 0; i < n8; i++)
+          {
+            kt[k][n8 + (32 / 8) + i] = kx[lanes * i + k]; /* PRF output */
+          }
+        }
+        for (i = 0; i < 25; i++)
+        {
+          kx[lanes * i + k] = kt[k][i];
+        }
+      }
+      keccak_f1600_xl(kx, lanes, (1u << l) - 1);
+      if (t == 0 && sk != NULL && si - j < l)
+      {
+        for (i = 0; i < n8; i++)
+        {
+          memcpy(sk + 8 * i, &kx[lanes * i + si - j], 8);
+        }
+      }
+    }
+
+    for (k = 0; k < l; k++)
+    {
+      for (i = 0; i < n8; i++)
+      {
+        memcpy(tmp + (j + k) * n + 8 * i, &kx[lanes * i + k], 8);
+      }
+    }
+  }
+  adrs_set_tree_index(var, ti);
+}
+
 /* parameter sets */
 
 const slh_param_t slh_dsa_shake_128s = {/* .alg_id = */ "SLH-DSA-SHAKE-128s",
@@ -239,16 +833,36 @@ const slh_param_t slh_dsa_shake_128s = {/* .alg_id = */ "SLH-DSA-SHAKE-128s",
                                         /* .k = */ 14,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 30,
+                                        /* .len1 = */ 32,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 35,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 704,
+                                        /* .fors_sz = */ 2912,
+                                        /* .sig_sz = */ 7856,
+                                        /* .md_sz = */ 21,
+                                        /* .tree_sz = */ 7,
+                                        /* .leaf_sz = */ 2,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 10,
+                                        /* .leaf_mask = */ (1 << 9) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
 
 const slh_param_t slh_dsa_shake_128f = {/* .alg_id = */ "SLH-DSA-SHAKE-128f",
                                         /* .n = */ 16,
@@ -259,16 +873,36 @@ const slh_param_t slh_dsa_shake_128f = {/* .alg_id = */ "SLH-DSA-SHAKE-128f",
                                         /* .k = */ 33,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 34,
+                                        /* .len1 = */ 32,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 35,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 608,
+                                        /* .fors_sz = */ 3696,
+                                        /* .sig_sz = */ 17088,
+                                        /* .md_sz = */ 25,
+                                        /* .tree_sz = */ 8,
+                                        /* .leaf_sz = */ 1,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 1,
+                                        /* .leaf_mask = */ (1 << 3) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
 
 const slh_param_t slh_dsa_shake_192s = {/* .alg_id = */ "SLH-DSA-SHAKE-192s",
                                         /* .n = */ 24,
@@ -279,16 +913,36 @@ const slh_param_t slh_dsa_shake_192s = {/* .alg_id = */ "SLH-DSA-SHAKE-192s",
                                         /* .k = */ 17,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 39,
+                                        /* .len1 = */ 48,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 51,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 1440,
+                                        /* .fors_sz = */ 6120,
+                                        /* .sig_sz = */ 16224,
+                                        /* .md_sz = */ 30,
+                                        /* .tree_sz = */ 7,
+                                        /* .leaf_sz = */ 2,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 10,
+                                        /* .leaf_mask = */ (1 << 9) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
 
 const slh_param_t slh_dsa_shake_192f = {/* .alg_id = */ "SLH-DSA-SHAKE-192f",
                                         /* .n = */ 24,
@@ -299,16 +953,36 @@ const slh_param_t slh_dsa_shake_192f = {/* .alg_id = */ "SLH-DSA-SHAKE-192f",
                                         /* .k = */ 33,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 42,
+                                        /* .len1 = */ 48,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 51,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 1296,
+                                        /* .fors_sz = */ 7128,
+                                        /* .sig_sz = */ 35664,
+                                        /* .md_sz = */ 33,
+                                        /* .tree_sz = */ 8,
+                                        /* .leaf_sz = */ 1,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 1,
+                                        /* .leaf_mask = */ (1 << 3) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
 
 const slh_param_t slh_dsa_shake_256s = {/* .alg_id = */ "SLH-DSA-SHAKE-256s",
                                         /* .n = */ 32,
@@ -319,16 +993,36 @@ const slh_param_t slh_dsa_shake_256s = {/* .alg_id = */ "SLH-DSA-SHAKE-256s",
                                         /* .k = */ 22,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 47,
+                                        /* .len1 = */ 64,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 67,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 2400,
+                                        /* .fors_sz = */ 10560,
+                                        /* .sig_sz = */ 29792,
+                                        /* .md_sz = */ 39,
+                                        /* .tree_sz = */ 7,
+                                        /* .leaf_sz = */ 1,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 8,
+                                        /* .leaf_mask = */ (1 << 8) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
 
 const slh_param_t slh_dsa_shake_256f = {/* .alg_id = */ "SLH-DSA-SHAKE-256f",
                                         /* .n = */ 32,
@@ -339,13 +1033,39 @@ const slh_param_t slh_dsa_shake_256f = {/* .alg_id = */ "SLH-DSA-SHAKE-256f",
                                         /* .k = */ 35,
                                         /* .lg_w = */ 4,
                                         /* .m = */ 49,
+                                        /* .len1 = */ 64,
+                                        /* .len2 = */ 3,
+                                        /* .len = */ 67,
+                                        /* .csum_shl = */ 4,
+                                        /* .csum_sz = */ 2,
+                                        /* .xmss_sz = */ 2272,
+                                        /* .fors_sz = */ 11200,
+                                        /* .sig_sz = */ 49856,
+                                        /* .md_sz = */ 40,
+                                        /* .tree_sz = */ 8,
+                                        /* .leaf_sz = */ 1,
+                                        /* .tree_mask = */ ~UINT64_C(0) >> 0,
+                                        /* .leaf_mask = */ (1 << 4) - 1,
                                         /* .mk_var = */ shake_mk_var,
                                         /* .chain = */ shake_chain,
+                                        /* .chain_x = */ shake_chain_x,
                                         /* .wots_chain = */ shake_wots_chain,
+                                        /* .wots_chain_x = */
+                                        shake_wots_chain_x,
                                         /* .fors_hash = */ shake_fors_hash,
+                                        /* .fors_hash_x = */
+                                        shake_fors_hash_x,
                                         /* .h_msg = */ shake_h_msg,
                                         /* .prf = */ shake_prf,
                                         /* .prf_msg = */ shake_prf_msg,
                                         /* .h_f = */ shake_f,
                                         /* .h_h = */ shake_h,
-                                        /* .h_t = */ shake_t};
+                                        /* .h_h_x = */ shake_h_x,
+                                        /* .h_t = */ shake_t,
+                                        /* .h_t_x = */ shake_t_x};
+
+#else /* SLH_FIXED_PARAM && !SLH_FIXED_UNIT */
+
+SLH_EMPTY_CU(slh_shake)
+
+#endif /* SLH_FIXED_PARAM */
@@ -37,4 +37,11 @@
 #endif /* inline */
 #endif /* !SLH_INLINE */
 
+/*
+ * ISO C forbids empty translation units. Source files whose entire content
+ * is conditional on the target (e.g. x86-64 SIMD kernels) use this to leave
+ * a harmless declaration behind when they are compiled out.
+ */
+#define SLH_EMPTY_CU(s) extern int slh_empty_cu_##s;
+
 #endif /* SLH_SYS_H */
@@ -13,6 +13,77 @@
 
 /* some structural sizes */
 
+#ifdef SLH_FIXED_PARAM
+
+/* single parameter set build: sizes of the set named by SLH_FIXED_PARAM */
+#define SLH_SZ_CAT_(a, b) a##b
+#define SLH_SZ_CAT(a, b) SLH_SZ_CAT_(a, b)
+#define SLH_SZ(f) SLH_SZ_CAT(f, SLH_SZ_CAT(SLH_SZ_, SLH_FIXED_PARAM))
+
+/* FIPS 205 parameter set name -> security category */
+#define SLH_SZ_slh_dsa_sha2_128s _128s
+#define SLH_SZ_slh_dsa_sha2_128f _128f
+#define SLH_SZ_slh_dsa_sha2_192s _192s
+#define SLH_SZ_slh_dsa_sha2_192f _192f
+#define SLH_SZ_slh_dsa_sha2_256s _256s
+#define SLH_SZ_slh_dsa_sha2_256f _256f
+#define SLH_SZ_slh_dsa_shake_128s _128s
+#define SLH_SZ_slh_dsa_shake_128f _128f
+#define SLH_SZ_slh_dsa_shake_192s _192s
+#define SLH_SZ_slh_dsa_shake_192f _192f
+#define SLH_SZ_slh_dsa_shake_256s _256s
+#define SLH_SZ_slh_dsa_shake_256f _256f
+
+/* n, k, hp, a, m of each category (FIPS 205, Table 2) */
+#define SLH_SZ_N_128s 16
+#define SLH_SZ_K_128s 14
+#define SLH_SZ_HP_128s 9
+#define SLH_SZ_A_128s 12
+#define SLH_SZ_M_128s 30
+
+#define SLH_SZ_N_128f 16
+#define SLH_SZ_K_128f 33
+#define SLH_SZ_HP_128f 3
+#define SLH_SZ_A_128f 6
+#define SLH_SZ_M_128f 34
+
+#define SLH_SZ_N_192s 24
+#define SLH_SZ_K_192s 17
+#define SLH_SZ_HP_192s 9
+#define SLH_SZ_A_192s 14
+#define SLH_SZ_M_192s 39
+
+#define SLH_SZ_N_192f 24
+#define SLH_SZ_K_192f 33
+#define SLH_SZ_HP_192f 3
+#define SLH_SZ_A_192f 8
+#define SLH_SZ_M_192f 42
+
+#define SLH_SZ_N_256s 32
+#define SLH_SZ_K_256s 22
+#define SLH_SZ_HP_256s 8
+#define SLH_SZ_A_256s 14
+#define SLH_SZ_M_256s 47
+
+#define SLH_SZ_N_256f 32
+#define SLH_SZ_K_256f 35
+#define SLH_SZ_HP_256f 4
+#define SLH_SZ_A_256f 9
+#define SLH_SZ_M_256f 49
+
+/* (an unlisted name leaves these 0 and the general maxima below apply) */
+#if SLH_SZ(SLH_SZ_N) > 0
+#define SLH_MAX_N SLH_SZ(SLH_SZ_N)
+#define SLH_MAX_LEN (2 * SLH_MAX_N + 3)
+#define SLH_MAX_K SLH_SZ(SLH_SZ_K)
+#define SLH_MAX_HP SLH_SZ(SLH_SZ_HP)
+#define SLH_MAX_A SLH_SZ(SLH_SZ_A)
+#define SLH_MAX_M SLH_SZ(SLH_SZ_M)
+#endif
+
+#endif /* SLH_FIXED_PARAM */
+
+#ifndef SLH_MAX_N
 #ifdef SLH_EXPERIMENTAL
 
 /* a and hp adjusted to facilitate experimental parameter sets */
@@ -33,6 +104,17 @@
 #define SLH_MAX_A 14
 #define SLH_MAX_M 49
 
+#endif
+#endif /* !SLH_MAX_N */
+
+/* leaves generated together with the multi-lane hash callbacks; */
+/* without multi-lane kernels, only the stack frames would grow */
+#ifdef PLAT_X64_SIMD
+#define SLH_LEAF_X 8  /* XMSS (WOTS+ public keys) per batch */
+#define SLH_TREE_X 64 /* subtree leaves hashed level by level */
+#else
+#define SLH_LEAF_X 1
+#define SLH_TREE_X 4
 #endif
 
 /* context */
@@ -50,6 +132,11 @@ struct slh_var_s
   /* precomputed values */
   sha2_256_t sha2_256_pk_seed;
   sha2_512_t sha2_512_pk_seed;
+
+  /* padded single blocks for ADRSc || M after the PK.seed midstate */
+  uint32_t sha2_256_f_blk[16]; /* F and PRF, |M| = n */
+  uint32_t sha2_256_h_blk[16]; /* H, |M| = 2n, n = 16 */
+  uint64_t sha2_512_h_blk[16]; /* H, |M| = 2n, n > 16 */
 };
 
 /* === Lower-level functions */
@@ -156,6 +156,28 @@ int std_smoke_test()
   return fail;
 }
 
+/* the static layout of the standard sets must match slh_param_layout() */
+
+int std_layout_test()
+{
+  int i;
+  int fail = 0;
+  slh_param_t prm;
+
+  for (i = 0; std_iut[i] != NULL; i++)
+  {
+    memcpy(&prm, std_iut[i], sizeof(slh_param_t));
+    slh_param_layout(&prm);
+    if (memcmp(&prm, std_iut[i], sizeof(slh_param_t)) != 0)
+    {
+      printf("[FAIL] %s  slh_param_layout() mismatch\n", prm.alg_id);
+      fail++;
+    }
+  }
+
+  return fail;
+}
+
 int new_smoke_test(const char *alg_id, const char *hash, uint32_t n, uint32_t h,
                    uint32_t d, uint32_t hp, uint32_t a, uint32_t k,
                    uint32_t lg_w, uint32_t m, uint64_t seed)
@@ -227,6 +249,7 @@ int new_smoke_test(const char *alg_id, const char *hash, uint32_t n, uint32_t h,
   prm.k = k;
   prm.lg_w = lg_w;
   prm.m = m;
+  slh_param_layout(&prm);
 
   /* smoke test */
   fail += test_param(&prm, seed);
@@ -248,6 +271,7 @@ int main(int argc, char **argv)
 
   if (argc <= 1)
   {
+    fail += std_layout_test();
     fail += std_smoke_test();
     return fail;
   }
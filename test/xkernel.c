@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) The slhdsa-c project authors
+ * SPDX-License-Identifier: Apache-2.0 OR ISC OR MIT
+ */
+
+/* === hash kernel and multi-lane callback checks against the portable code */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../sha2_api.h"
+#include "../sha3_api.h"
+#include "../slh_dsa.h"
+#include "../slh_adrs.h"
+
+/* instrumentation */
+extern uint64_t sha2_256_compress_count; /* sha2_256.c      */
+extern uint64_t sha2_512_compress_count; /* sha2_512.c      */
+extern uint64_t keccak_f1600_count;      /* sha3_f1600.c    */
+
+/* features reported by plat_x64_features(); all subsets are tested */
+#ifdef PLAT_X64_SIMD
+extern uint32_t plat_x64_mask; /* plat_cpuid.c    */
+#define FEAT_MASKS 8
+#else
+#define FEAT_MASKS 1
+#endif
+
+/* FIPS 205 test targets */
+static const slh_param_t *std_iut[] = {&slh_dsa_shake_128s,
+                                       &slh_dsa_shake_128f,
+                                       &slh_dsa_shake_192s,
+                                       &slh_dsa_shake_192f,
+                                       &slh_dsa_shake_256s,
+                                       &slh_dsa_shake_256f,
+                                       &slh_dsa_sha2_128s,
+                                       &slh_dsa_sha2_128f,
+                                       &slh_dsa_sha2_192s,
+                                       &slh_dsa_sha2_192f,
+                                       &slh_dsa_sha2_256s,
+                                       &slh_dsa_sha2_256f,
+                                       NULL};
+
+/* active lanes of the multi-lane kernel calls; odd counts included */
+static const uint32_t act_tv[] = {0xFFFF, 0x0001, 0x0007, 0x8000, 0x5A5A,
+                                  0x00FE, 0x7FFF, 0x1234, 0x0000};
+
+/* number of items of the multi-lane callback calls */
+static const uint32_t nx_tv[] = {1, 3, 5, 9, 15, 17, 35, SLH_MAX_LEN};
+
+#define NX_MAX SLH_MAX_LEN
+
+/* 25 lanes of Keccak-f[1600] applied to the all-zero state */
+static const uint64_t keccak_zero_kat[25] = {
+    0xF1258F7940E1DDE7, 0x84D5CCF933C0478A, 0xD598261EA65AA9EE,
+    0xBD1547306F80494D, 0x8B284E056253D057, 0xFF97A42D7F8E6FD4,
+    0x90FEE5A0A44647C4, 0x8C5BDA0CD6192E76, 0xAD30A6F71B19059C,
+    0x30935AB7D08FFC64, 0xEB5AA93F2317D635, 0xA9A6E6260D712103,
+    0x81A57C16DBCF555F, 0x43B831CD0347C826, 0x01F22F1A11A5569F,
+    0x05E5635A21D9AE61, 0x64BEFEF28CC970F2, 0x613670957BC46611,
+    0xB87C5A554FD00ECB, 0x8C3EE88A1CCF32C8, 0x940C7922AE3A2614,
+    0x1841F924A2C509E4, 0x16F53526E70465C2, 0x75F644E97F30A13B,
+    0xEAF1FF7B5CECA249};
+
+uint64_t lcg_fill(void *buf, size_t buf_sz, uint64_t x)
+{
+  size_t i;
+
+  for (i = 0; i < buf_sz; i++)
+  {
+    /*  arbitrary LCG parameters */
+    /*  nuclear.llnl.gov/CNP/rng/rngman.pdf */
+    x = 2862933555777941757 * x + 3037000493;
+    ((uint8_t *)buf)[i] = x >> 56;
+  }
+
+  return x;
+}
+
+void set_mask(uint32_t mask)
+{
+#ifdef PLAT_X64_SIMD
+  plat_x64_mask = mask;
+#else
+  (void)mask;
+#endif
+}
+
+uint64_t hash_count()
+{
+  uint64_t tot;
+  tot = sha2_256_compress_count + sha2_512_compress_count + keccak_f1600_count;
+  return tot;
+}
+
+int popcount(uint32_t x)
+{
+  int c = 0;
+
+  while (x != 0)
+  {
+    c += x & 1;
+    x >>= 1;
+  }
+  return c;
+}
+
+/* single-lane kernels in the multi-lane calling convention */
+
+void sha2_256_compress_x1(void *v[1], uint32_t act)
+{
+  if (act & 1)
+  {
+    sha2_256_compress(v[0]);
+  }
+}
+
+void sha2_512_compress_x1(void *v[1], uint32_t act)
+{
+  if (act & 1)
+  {
+    sha2_512_compress(v[0]);
+  }
+}
+
+void keccak_f1600_x1(uint64_t x[25], uint32_t act)
+{
+  if (act & 1)
+  {
+    keccak_f1600(x);
+  }
+}
+
+/* "nl"-lane "compress_x" under feature mask "mask" against the portable */
+/* "compress" on the lanes in "act"; the counter must add only those */
+
+int sha2_x_test(const char *name, void (*compress)(void *v),
+                void (*compress_x)(void *v[], uint32_t act),
+                const uint64_t *count, size_t v_sz, uint32_t nl,
+                uint32_t mask, uint32_t act, uint64_t seed)
+{
+  uint64_t v[16][(64 + 128) / 8], r[16][(64 + 128) / 8];
+  void *vp[16];
+  uint64_t c;
+  uint32_t i;
+  int fail = 0;
+
+  act &= (1u << nl) - 1;
+  lcg_fill(v, sizeof(v), seed);
+  memcpy(r, v, sizeof(r));
+
+  set_mask(0);
+  for (i = 0; i < nl; i++)
+  {
+    vp[i] = v[i];
+    if ((act >> i) & 1)
+    {
+      compress(r[i]);
+    }
+  }
+
+  set_mask(mask);
+  c = *count;
+  compress_x(vp, act);
+  c = *count - c;
+
+  for (i = 0; i < nl; i++)
+  {
+    if (((act >> i) & 1) && memcmp(v[i], r[i], v_sz) != 0)
+    {
+      fail++;
+    }
+  }
+  if (fail != 0 || c != (uint64_t)popcount(act))
+  {
+    printf("[FAIL] %s  mask=%x act=%04x lanes=%d count=%u\n", name,
+           (unsigned)mask, (unsigned)act, fail, (unsigned)c);
+    return 1;
+  }
+  return 0;
+}
+
+/* "nl"-state "perm_x" (lane i of state j is in x[nl * i + j]) against */
+/* the portable keccak_f1600() on the states in "act" */
+
+int keccak_x_test(const char *name, void (*perm_x)(uint64_t *x, uint32_t act),
+                  uint32_t nl, uint32_t mask, uint32_t act, uint64_t seed)
+{
+  uint64_t x[8 * 25], r[8][25];
+  uint64_t c;
+  uint32_t i, j;
+  int fail = 0;
+
+  act &= (1u << nl) - 1;
+  lcg_fill(x, sizeof(x), seed);
+
+  set_mask(0);
+  for (j = 0; j < nl; j++)
+  {
+    for (i = 0; i < 25; i++)
+    {
+      r[j][i] = x[nl * i + j];
+    }
+    if ((act >> j) & 1)
+    {
+      keccak_f1600(r[j]);
+    }
+  }
+
+  set_mask(mask);
+  c = keccak_f1600_count;
+  perm_x(x, act);
+  c = keccak_f1600_count - c;
+
+  for (j = 0; j < nl; j++)
+  {
+    for (i = 0; i < 25 && ((act >> j) & 1); i++)
+    {
+      if (x[nl * i + j] != r[j][i])
+      {
+        fail++;
+        break;
+      }
+    }
+  }
+  if (fail != 0 || c != (uint64_t)popcount(act))
+  {
+    printf("[FAIL] %s  mask=%x act=%04x lanes=%d count=%u\n", name,
+           (unsigned)mask, (unsigned)act, fail, (unsigned)c);
+    return 1;
+  }
+  return 0;
+}
+
+/* the permutation(s) on a known state */
+
+int keccak_kat_test()
+{
+  uint64_t x[25];
+  int fail = 0;
+#if PLAT_XLEN == 32
+  uint32_t w[50];
+#endif
+
+  memset(x, 0, sizeof(x));
+  keccak_f1600(x);
+  if (memcmp(x, keccak_zero_kat, sizeof(x)) != 0)
+  {
+    printf("[FAIL] keccak_f1600  zero state\n");
+    fail++;
+  }
+
+#if PLAT_XLEN == 32
+  memset(x, 0, sizeof(x));
+  keccak_bi32_in(w, x);
+  keccak_f1600_bi32(w);
+  keccak_bi32_out(x, w);
+  if (memcmp(x, keccak_zero_kat, sizeof(x)) != 0)
+  {
+    printf("[FAIL] keccak_f1600_bi32  zero state\n");
+    fail++;
+  }
+#endif
+
+  return fail;
+}
+
+int kernel_test(uint32_t mask)
+{
+  size_t i;
+  int fail = 0;
+
+  for (i = 0; i < sizeof(act_tv) / sizeof(act_tv[0]); i++)
+  {
+    fail += sha2_x_test("sha2_256_compress", sha2_256_compress,
+                        sha2_256_compress_x1, &sha2_256_compress_count, 32 + 64,
+                        1, mask, act_tv[i], i);
+    fail += sha2_x_test("sha2_256_compress_x8", sha2_256_compress,
+                        sha2_256_compress_x8, &sha2_256_compress_count, 32 + 64,
+                        8, mask, act_tv[i], i);
+    fail += sha2_x_test("sha2_256_compress_x16", sha2_256_compress,
+                        sha2_256_compress_x16, &sha2_256_compress_count,
+                        32 + 64, 16, mask, act_tv[i], i);
+    fail += sha2_x_test("sha2_512_compress", sha2_512_compress,
+                        sha2_512_compress_x1, &sha2_512_compress_count,
+                        64 + 128, 1, mask, act_tv[i], i);
+    fail += sha2_x_test("sha2_512_compress_x4", sha2_512_compress,
+                        sha2_512_compress_x4, &sha2_512_compress_count,
+                        64 + 128, 4, mask, act_tv[i], i);
+    fail += sha2_x_test("sha2_512_compress_x8", sha2_512_compress,
+                        sha2_512_compress_x8, &sha2_512_compress_count,
+                        64 + 128, 8, mask, act_tv[i], i);
+    fail += keccak_x_test("keccak_f1600", keccak_f1600_x1, 1, mask, act_tv[i],
+                          i);
+    fail += keccak_x_test("keccak_f1600_x4", keccak_f1600_x4, 4, mask,
+                          act_tv[i], i);
+    fail += keccak_x_test("keccak_f1600_x8", keccak_f1600_x8, 8, mask,
+                          act_tv[i], i);
+  }
+
+  return fail;
+}
+
+/* outputs and hash counts must match the single-lane run */
+
+int callback_check(const slh_param_t *prm, const char *name, uint32_t mask,
+                   uint32_t nx, int diff, uint64_t c0, uint64_t c1)
+{
+  if (diff != 0 || c0 != c1)
+  {
+    printf("[FAIL] %s  %s  mask=%x nx=%u count=%u/%u\n", prm->alg_id, name,
+           (unsigned)mask, (unsigned)nx, (unsigned)c1, (unsigned)c0);
+    return 1;
+  }
+  return 0;
+}
+
+/* multi-lane callbacks of "prm" with "nx" items under feature mask */
+/* "mask" against their single-lane counterparts with no features */
+
+int callback_test(const slh_param_t *prm, uint32_t mask, uint32_t nx,
+                  uint64_t seed)
+{
+  static uint8_t m[NX_MAX * SLH_MAX_LEN * SLH_MAX_N];
+  static uint8_t h[2][NX_MAX * SLH_MAX_N];
+  uint8_t sk[4 * SLH_MAX_N], sv[2][SLH_MAX_N];
+  uint32_t rv[2][NX_MAX];
+  uint32_t kp[NX_MAX], ci[NX_MAX], vi[NX_MAX], vs[NX_MAX];
+  slh_var_t var;
+  adrs_t a0;
+  uint64_t c0, c1;
+  size_t n = prm->n;
+  size_t m_sz = prm->len * n;
+  uint32_t w = 1u << prm->lg_w;
+  uint32_t j, s, si;
+  int fail = 0;
+
+  seed = lcg_fill(sk, sizeof(sk), seed);
+  seed = lcg_fill(m, sizeof(m), seed);
+  seed = lcg_fill(rv, sizeof(rv), seed);
+  for (j = 0; j < nx; j++)
+  {
+    kp[j] = 3 + j / prm->len;
+    ci[j] = j % prm->len;
+    vi[j] = rv[0][j] % w;
+    vs[j] = rv[1][j] % (w - vi[j]);
+  }
+
+  set_mask(0);
+  prm->mk_var(&var, NULL, sk, prm);
+  adrs_zero(&var);
+  adrs_set_layer_address(&var, 1);
+  adrs_set_tree_address(&var, 0x0123456789);
+
+  /* WOTS+ secret keys chained for vi[j] steps */
+  adrs_set_type_and_clear_not_kp(&var, ADRS_WOTS_HASH);
+  adrs_set_key_pair_address(&var, 9);
+  a0 = *var.adrs;
+  c0 = hash_count();
+  for (j = 0; j < nx; j++)
+  {
+    *var.adrs = a0;
+    adrs_set_key_pair_address(&var, kp[j]);
+    adrs_set_chain_address(&var, ci[j]);
+    prm->wots_chain(&var, h[0] + j * n, vi[j]);
+  }
+  c0 = hash_count() - c0;
+  set_mask(mask);
+  *var.adrs = a0;
+  c1 = hash_count();
+  prm->wots_chain_x(&var, h[1], kp, ci, vi, nx);
+  c1 = hash_count() - c1;
+  fail += callback_check(prm, "wots_chain_x", mask, nx,
+                         memcmp(h[0], h[1], nx * n), c0, c1);
+
+  /* T_l: WOTS+ public keys with consecutive key pair addresses */
+  adrs_set_type_and_clear_not_kp(&var, ADRS_WOTS_PK);
+  adrs_set_key_pair_address(&var, 5);
+  a0 = *var.adrs;
+  set_mask(0);
+  c0 = hash_count();
+  for (j = 0; j < nx; j++)
+  {
+    adrs_set_key_pair_address(&var, 5 + j);
+    prm->h_t(&var, h[0] + j * n, m + j * m_sz, m_sz);
+  }
+  c0 = hash_count() - c0;
+  set_mask(mask);
+  *var.adrs = a0;
+  c1 = hash_count();
+  prm->h_t_x(&var, h[1], m, m_sz, nx);
+  c1 = hash_count() - c1;
+  fail += callback_check(prm, "h_t_x", mask, nx,
+                         memcmp(h[0], h[1], nx * n) ||
+                             memcmp(var.adrs, &a0, sizeof(a0)),
+                         c0, c1);
+
+  /* FORS secret keys (s = 0) and leaves (s = 1); the secret value of */
+  /* leaf "si" is also returned */
+  si = rv[0][0] % nx;
+  for (s = 0; s < 2; s++)
+  {
+    adrs_set_type_and_clear_not_kp(&var, ADRS_FORS_TREE);
+    adrs_set_key_pair_address(&var, 7);
+    adrs_set_tree_index(&var, 100);
+    a0 = *var.adrs;
+    set_mask(0);
+    c0 = hash_count();
+    for (j = 0; j < nx; j++)
+    {
+      *var.adrs = a0;
+      adrs_set_tree_index(&var, 100 + j);
+      prm->fors_hash(&var, h[0] + j * n, s);
+    }
+    c0 = hash_count() - c0;
+    if (s == 0)
+    {
+      memcpy(sv[0], h[0] + si * n, n);
+    }
+    set_mask(mask);
+    *var.adrs = a0;
+    c1 = hash_count();
+    prm->fors_hash_x(&var, h[1], s, nx, sv[1], si);
+    c1 = hash_count() - c1;
+    fail += callback_check(prm, s == 0 ? "fors_hash_x(0)" : "fors_hash_x(1)",
+                           mask, nx,
+                           memcmp(h[0], h[1], nx * n) |
+                               memcmp(sv[0], sv[1], n),
+                           c0, c1);
+  }
+
+  /* H: tree nodes with consecutive tree indices */
+  adrs_set_type_and_clear(&var, ADRS_TREE);
+  adrs_set_tree_height(&var, 3);
+  adrs_set_tree_index(&var, 40);
+  a0 = *var.adrs;
+  set_mask(0);
+  c0 = hash_count();
+  for (j = 0; j < nx; j++)
+  {
+    adrs_set_tree_index(&var, 40 + j);
+    prm->h_h(&var, h[0] + j * n, m + 2 * j * n, m + (2 * j + 1) * n);
+  }
+  c0 = hash_count() - c0;
+  set_mask(mask);
+  *var.adrs = a0;
+  c1 = hash_count();
+  prm->h_h_x(&var, h[1], m, nx);
+  c1 = hash_count() - c1;
+  fail += callback_check(prm, "h_h_x", mask, nx,
+                         memcmp(h[0], h[1], nx * n) ||
+                             memcmp(var.adrs, &a0, sizeof(a0)),
+                         c0, c1);
+
+  /* WOTS+ chains from step vi[j] for vs[j] steps */
+  adrs_set_type_and_clear_not_kp(&var, ADRS_WOTS_HASH);
+  adrs_set_key_pair_address(&var, 9);
+  a0 = *var.adrs;
+  set_mask(0);
+  c0 = hash_count();
+  for (j = 0; j < nx; j++)
+  {
+    *var.adrs = a0;
+    adrs_set_chain_address(&var, ci[j]);
+    prm->chain(&var, h[0] + j * n, m + j * n, vi[j], vs[j]);
+  }
+  c0 = hash_count() - c0;
+  set_mask(mask);
+  *var.adrs = a0;
+  c1 = hash_count();
+  prm->chain_x(&var, h[1], m, ci, vi, vs, nx);
+  c1 = hash_count() - c1;
+  fail += callback_check(prm, "chain_x", mask, nx,
+                         memcmp(h[0], h[1], nx * n), c0, c1);
+
+  return fail;
+}
+
+int main()
+{
+  uint32_t mask;
+  size_t i, j;
+  int fail = 0;
+
+  fail += keccak_kat_test();
+
+  for (mask = 0; mask < FEAT_MASKS; mask++)
+  {
+    fail += kernel_test(mask);
+    for (i = 0; std_iut[i] != NULL; i++)
+    {
+      for (j = 0; j < sizeof(nx_tv) / sizeof(nx_tv[0]); j++)
+      {
+        fail += callback_test(std_iut[i], mask, nx_tv[j], 16 * i + j);
+      }
+    }
+  }
+  set_mask(0xFFFFFFFF);
+
+  printf("[%s] xkernel  feature masks=%d  FAIL=%d\n",
+         fail == 0 ? "PASS" : "FAIL", FEAT_MASKS, fail);
+
+  return fail;
+}